@@ -1,55 +1,188 @@
 #include <QGuiApplication>
 #include <qquickview.h>
 #include <qqmlcontext.h>
+#include <qqml.h>
 #include <qabstracteventdispatcher.h>
 #include <qtimer.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qthread.h>
 #include "sampleModel.h"
-#include <iostream>
+#include "samplePagedStore.h"
+#include "sampleTickScheduler.h"
+#include "sampleWindows.h"
+#include "sampleProgressList.h"
+#include "sampleTrace.h"
 
 int main(int argc, char *argv[])
 {
+    // Startup marks are measured from here, --startup prints them as they are recorded
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     QGuiApplication app(argc, argv);
     QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
 
     SampleModel::qmlRegisterTypes();
-    SampleModel model;
-    const int startItemAmount = 9;
-    for (int i = 0; i < startItemAmount; ++i)
+    // Register to allow context_windows.showWindow(SampleWindows.PaletteWindow) in QML
+    qmlRegisterUncreatableType<SampleWindows>("SampleModel", 1, 0, "SampleWindows", "Windows belong to the application");
+    // Register to allow SampleProgressList { model: context_model } in QML
+    qmlRegisterType<SampleProgressList>("SampleModel", 1, 0, "SampleProgressList");
+    // Column storage avoids a QObject per row for very large item counts
+    const QStringList arguments = QCoreApplication::arguments();
+    const bool useColumns = arguments.contains("--columns");
+
+    // Paged storage reads the rows from a dataset file, --dataset-rows writes one first
+    const int datasetIndex = arguments.indexOf("--dataset");
+    const QString datasetPath = datasetIndex >= 0 ? arguments.value(datasetIndex + 1) : QString();
+    const int datasetRowsIndex = arguments.indexOf("--dataset-rows");
+    if (!datasetPath.isEmpty() && datasetRowsIndex >= 0)
+    {
+        SamplePagedStore::createDataset(datasetPath, arguments.value(datasetRowsIndex + 1).toInt(), "Sample Item ");
+    }
+
+    SampleModel model(!datasetPath.isEmpty() ? SampleModel::PagedStorage :
+        useColumns ? SampleModel::ColumnStorage : SampleModel::ObjectStorage);
+
+    // Records a timeline from start up, written on exit or after --trace-seconds to open in chrome://tracing or Perfetto
+    const int traceIndex = arguments.indexOf("--trace");
+    const QString tracePath = traceIndex >= 0 ? arguments.value(traceIndex + 1) : QString();
+    if (!tracePath.isEmpty())
     {
-        model.createItem(("Sample Item " + std::to_string(i)).c_str());
+        SampleTrace::start();
     }
 
+    // The palette and picker are created after the main view's first frame, or on first use with --lazy-windows
     QQuickView view;
+    SampleWindows windows(view, startupTimer);
+    windows.setCreation(arguments.contains("--lazy-windows") ? SampleWindows::OnDemandCreation : SampleWindows::DeferredCreation);
+    if (arguments.contains("--startup"))
+    {
+        QObject::connect(&windows, &SampleWindows::marked, [](const QString& name, double ms)
+        {
+            qInfo("startup %s\t%.3f ms", qPrintable(name), ms);
+        });
+    }
+    windows.mark("engine");
+
+    // A snapshot replaces the initial items and is saved again on exit
+    const int snapshotIndex = arguments.indexOf("--snapshot");
+    const QString snapshotPath = snapshotIndex >= 0 ? arguments.value(snapshotIndex + 1) : QString();
+    if (!snapshotPath.isEmpty() && QFile::exists(snapshotPath))
+    {
+        QElapsedTimer restoreTimer;
+        restoreTimer.start();
+        const bool restored = model.restoreSnapshot(snapshotPath);
+        qInfo("%s %d items in %.3f ms", restored ? "Restored" : "Unable to restore", model.rowCount(),
+            restoreTimer.nsecsElapsed() / 1e6);
+    }
+    else if (datasetPath.isEmpty())
+    {
+        const int startItemAmount = 9;
+        model.createItems(startItemAmount, "Sample Item ");
+    }
+    else if (!model.openDataset(datasetPath))
+    {
+        qWarning("Unable to open dataset %s", qPrintable(datasetPath));
+    }
+
+    // Records every model call to a journal that qtSampleBench --journal replays headless
+    const int journalIndex = arguments.indexOf("--journal");
+    if (journalIndex >= 0 && !model.startJournal(arguments.value(journalIndex + 1)))
+    {
+        qWarning("Unable to record journal %s", qPrintable(arguments.value(journalIndex + 1)));
+    }
+
+    // Split stepping across all cores once there are enough items to be worth it
+    if (arguments.contains("--parallel"))
+    {
+        model.setTickThreads(QThread::idealThreadCount());
+    }
+
+    // Step items on a worker thread, the timer below then only applies its snapshots
+    if (arguments.contains("--threaded"))
+    {
+        model.setThreadedTick(true);
+    }
+
+    // Records metrics for the overlay, --metrics-json also writes them out on exit
+    const int metricsJsonIndex = arguments.indexOf("--metrics-json");
+    const QString metricsJsonPath = metricsJsonIndex >= 0 ? arguments.value(metricsJsonIndex + 1) : QString();
+    model.metrics()->setEnabled(arguments.contains("--metrics") || !metricsJsonPath.isEmpty());
+
+    windows.mark("items");
+
     view.setResizeMode(QQuickView::SizeRootObjectToView);
     view.setTitle("Qt Sample");
     QQmlContext* ctxt = view.rootContext();
     ctxt->setContextProperty("context_model", &model);
-    view.setSource(QUrl("qrc:/main.qml"));
+    ctxt->setContextProperty("context_windows", &windows);
+    // Draws the rows with a single scene graph item instead of a delegate per row
+    view.setSource(QUrl(arguments.contains("--progress-list") ? "qrc:/progressList.qml" : "qrc:/main.qml"));
+    windows.mark("main view loaded");
+    SampleTrace::traceWindow(&view);
     view.show();
 
-    QQuickView palette;
-    palette.setResizeMode(QQuickView::SizeRootObjectToView);
-    palette.setTitle("Qt Palette");
-    palette.setSource(QUrl("qrc:/palette.qml"));
-    palette.show();
-
-    QQuickView picker;
-    picker.setResizeMode(QQuickView::SizeRootObjectToView);
-    picker.setTitle("Qt Picker");
-    picker.setSource(QUrl("qrc:/picker.qml"));
-    picker.show();
+    // Writes the trace once it covers the given number of seconds and stops recording
+    const auto writeTrace = [&tracePath]()
+    {
+        if (SampleTrace::isEnabled())
+        {
+            SampleTrace::stop();
+            if (SampleTrace::dumpJson(tracePath))
+            {
+                qInfo("Wrote %llu trace events, %llu overwritten, to %s", SampleTrace::eventCount(),
+                    SampleTrace::droppedCount(), qPrintable(tracePath));
+            }
+            else
+            {
+                qWarning("Unable to write trace %s", qPrintable(tracePath));
+            }
+        }
+    };
+    const int traceSecondsIndex = arguments.indexOf("--trace-seconds");
+    if (!tracePath.isEmpty() && traceSecondsIndex >= 0)
+    {
+        QTimer::singleShot(arguments.value(traceSecondsIndex + 1).toInt() * 1000, writeTrace);
+    }
 
-    QTimer timer;
-    timer.setInterval(10);
-    QObject::connect(&timer, &QTimer::timeout, [&model]() { model.tick(); });
-    timer.start();
+    // Ticks only while items are stepping, either on a timer or once per frame of the main view
+    SampleTickScheduler scheduler(model);
+    if (arguments.contains("--frame-sync"))
+    {
+        scheduler.setFrameWindow(&view);
+    }
 
-    auto connection = std::make_shared<QMetaObject::Connection>();
-    *connection = QObject::connect(&timer, &QTimer::timeout, [connection]()
+    // Prints how often the event loop woke up and the main view rendered each second,
+    // wakeups should drop to about one (the report itself) once no items are stepping
+    QTimer wakeupTimer;
+    quint64 wakeups = 0;
+    quint64 frames = 0;
+    quint64 reportedTicks = 0;
+    if (arguments.contains("--wakeups"))
     {
-        std::cout << "Testing Auto Disconnect" << std::endl;
-        QObject::disconnect(*connection);
-    });
+        QObject::connect(QAbstractEventDispatcher::instance(), &QAbstractEventDispatcher::awake, [&wakeups]() { ++wakeups; });
+        QObject::connect(&view, &QQuickWindow::frameSwapped, &wakeupTimer, [&frames]() { ++frames; });
+        QObject::connect(&wakeupTimer, &QTimer::timeout, [&]()
+        {
+            qInfo("wakeups/s %llu\tframes/s %llu\tticks/s %llu\tidle ticks %llu", wakeups, frames,
+                scheduler.tickCount() - reportedTicks, scheduler.idleTickCount());
+            wakeups = 0;
+            frames = 0;
+            reportedTicks = scheduler.tickCount();
+        });
+        wakeupTimer.start(1000);
+    }
 
-    return app.exec();
+    const int result = app.exec();
+    writeTrace();
+    if (!metricsJsonPath.isEmpty() && !model.metrics()->dumpJson(metricsJsonPath))
+    {
+        qWarning("Unable to write metrics %s", qPrintable(metricsJsonPath));
+    }
+    if (!snapshotPath.isEmpty() && !model.saveSnapshot(snapshotPath))
+    {
+        qWarning("Unable to save snapshot %s", qPrintable(snapshotPath));
+    }
+    return result;
 }
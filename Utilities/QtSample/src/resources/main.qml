@@ -34,8 +34,8 @@ Rectangle {
             console.log(ObjectEnum.ONE + " " + ObjectEnum.TWO + " " + ObjectEnum.THREE);
 
             for(var i = 0; i < 3; i++) {
-                console.log(sampleModel.intListTest[i] + " " + typeof(sampleModel.intListTest[i]));
-                console.log(sampleModel.colorListTest[i] + " " + typeof(sampleModel.colorListTest[i]));
+                console.log(sampleModel.intListTest.at(i) + " " + typeof(sampleModel.intListTest.at(i)));
+                console.log(sampleModel.colorListTest.at(i) + " " + typeof(sampleModel.colorListTest.at(i)));
                 console.log(sampleModel.objectListTest[i].id + " " + typeof(sampleModel.objectListTest[i]));
             }
             var test = sampleModel.returnObjectList();
@@ -91,7 +91,11 @@ Rectangle {
 				function onMouseReleased(mouse) {
                     dragging = false
                     if (previousDelegateIndex != delegateIndex) {
-                        context_model.moveItems(previousDelegateIndex, delegateIndex);
+                        /** Undo the preview move so the model's own move is applied only once */
+                        var from = previousDelegateIndex;
+                        var to = delegateIndex;
+                        delegateModel.items.move(to, from);
+                        context_model.moveItems(from, to);
                     }
 
                     listView.currentIndex = index;
@@ -338,6 +342,22 @@ Rectangle {
                             context_model.deleteItem(listView.currentIndex)
                         }
                     }
+                    Button {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: root.buttonHeight
+                        text: "Palette"
+                        onClicked: {
+                            context_windows.showWindow(SampleWindows.PaletteWindow)
+                        }
+                    }
+                    Button {
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: root.buttonHeight
+                        text: "Picker"
+                        onClicked: {
+                            context_windows.showWindow(SampleWindows.PickerWindow)
+                        }
+                    }
                 }
             }
         }
@@ -404,4 +424,56 @@ Rectangle {
             }
         }
     }
+
+    /** Summary of all rows, read from the statistics the model keeps instead of visiting the rows */
+    Rectangle {
+        readonly property var summary: context_model.summary
+        anchors.left: parent.left
+        anchors.bottom: parent.bottom
+        anchors.margins: marginSize * 2
+        width: summaryText.implicitWidth + marginSize * 2
+        height: summaryText.implicitHeight + marginSize * 2
+        color: lightAltShade
+        opacity: 0.9
+        visible: summary.rows > 0
+
+        Text {
+            id: summaryText
+            anchors.centerIn: parent
+            font.pointSize: smallFont
+            text: parent.summary.rows + " items  "
+                + parent.summary.steppingCount + " running  "
+                + parent.summary.pausedCount + " paused  "
+                + parent.summary.completeCount + " complete"
+                + "  avg progress " + (parent.summary.averageProgress * 100).toFixed(1) + "%"
+        }
+    }
+
+    /** Live model metrics, shown while they are recorded */
+    Rectangle {
+        readonly property var metrics: context_model.metrics
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        anchors.margins: marginSize * 2
+        width: metricsText.implicitWidth + marginSize * 2
+        height: metricsText.implicitHeight + marginSize * 2
+        color: lightAltShade
+        opacity: 0.9
+        visible: metrics.enabled
+
+        Text {
+            id: metricsText
+            anchors.centerIn: parent
+            font.pointSize: smallFont
+            text: "ticks " + parent.metrics.ticks
+                + "  avg " + parent.metrics.tickAverageUs.toFixed(1) + " us"
+                + "  p95 " + parent.metrics.tickP95Us.toFixed(1) + " us"
+                + "  stepped " + parent.metrics.steppedPerTick.toFixed(1)
+                + "\ndataChanged " + parent.metrics.dataChangedCount + " (" + parent.metrics.dataChangedRows + " rows)"
+                + "  data() " + parent.metrics.dataCalls
+                + "\ninserted " + parent.metrics.insertedRows
+                + "  removed " + parent.metrics.removedRows
+                + "  moved " + parent.metrics.movedRows
+        }
+    }
 }
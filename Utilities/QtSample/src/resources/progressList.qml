@@ -0,0 +1,141 @@
+import QtQuick 2.9
+import QtQuick.Controls 2.3
+import QtQuick.Layouts 1.3
+import SampleModel 1.0
+
+/** Same list as main.qml drawn by a single SampleProgressList instead of a delegate per row */
+Rectangle {
+    id: root
+    width: 560
+    height: 260
+
+    /** Style properties */
+    readonly property int buttonHeight: 30
+    readonly property int rowHeight: 25
+    readonly property color darkShade: "#DDDDDD"
+    readonly property color lightAltShade: "#F5F5F5"
+    readonly property color lightShade: "white"
+    readonly property color dragHighlight: "red"
+    readonly property color darkHighlight: "#8EACFF"
+    readonly property color lightHighlight: "#E0E8FF"
+    readonly property int smallFont: 8
+    readonly property int marginSize: 4
+    readonly property int iconsSize: 16
+
+    readonly property int currentState: progressList.currentState
+
+    color: darkShade
+
+    ColumnLayout {
+        anchors.margins: marginSize
+        anchors.fill: parent
+
+        SampleProgressList {
+            id: progressList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            model: context_model
+            rowHeight: root.rowHeight
+            currentIndex: 0
+            font.pointSize: smallFont
+            rowColor: lightShade
+            alternateRowColor: lightAltShade
+            hoverColor: lightHighlight
+            selectedColor: darkHighlight
+            dragColor: dragHighlight
+            trackColor: darkShade
+            clip: true
+
+            onContextMenuRequested: {
+                contextMenu.popup(x, y)
+            }
+
+            ScrollBar {
+                id: scrollBar
+                anchors.top: parent.top
+                anchors.right: parent.right
+                anchors.bottom: parent.bottom
+                orientation: Qt.Vertical
+                policy: ScrollBar.AlwaysOn
+                size: progressList.contentHeight > 0 ? Math.min(1.0, progressList.height / progressList.contentHeight) : 1.0
+                position: progressList.contentHeight > 0 ? progressList.contentY / progressList.contentHeight : 0.0
+                onPositionChanged: {
+                    if (active) {
+                        progressList.contentY = position * progressList.contentHeight;
+                    }
+                }
+            }
+
+            Menu {
+                id: contextMenu
+                visible: false
+                MenuItem {
+                    text: "Start"
+                    icon.source: "qrc:///start.png"
+                    icon.width: iconsSize
+                    icon.height: iconsSize
+                    enabled: root.currentState >= 0 && root.currentState != SampleItemState.STEPPING
+                    onTriggered: {
+                        context_model.startItemProgress(progressList.currentIndex);
+                    }
+                }
+                MenuItem {
+                    text: "Pause"
+                    icon.source: "qrc:///pause.png"
+                    icon.width: iconsSize
+                    icon.height: iconsSize
+                    enabled: root.currentState == SampleItemState.STEPPING
+                    onTriggered: {
+                        context_model.pauseItemProgress(progressList.currentIndex);
+                    }
+                }
+                MenuItem {
+                    text: "Stop"
+                    icon.source: "qrc:///stop.png"
+                    icon.width: iconsSize
+                    icon.height: iconsSize
+                    enabled: root.currentState == SampleItemState.STEPPING || root.currentState == SampleItemState.PAUSED
+                    onTriggered: {
+                        context_model.stopItemProgress(progressList.currentIndex);
+                    }
+                }
+                MenuItem {
+                    text: "Delete"
+                    icon.source: "qrc:///delete.png"
+                    icon.width: iconsSize
+                    icon.height: iconsSize
+                    onTriggered: {
+                        context_model.deleteItem(progressList.currentIndex);
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            TextField {
+                id: nameField
+                Layout.fillWidth: true
+                Layout.preferredHeight: root.buttonHeight
+                placeholderText: "Item name"
+            }
+            Button {
+                Layout.preferredHeight: root.buttonHeight
+                text: "Create Item"
+                enabled: nameField.text.length > 0
+                onClicked: {
+                    context_model.createItem(nameField.text);
+                    nameField.text = "";
+                    progressList.positionViewAtEnd();
+                }
+            }
+            Button {
+                Layout.preferredHeight: root.buttonHeight
+                text: "Delete Item"
+                onClicked: {
+                    context_model.deleteItem(progressList.currentIndex);
+                }
+            }
+        }
+    }
+}
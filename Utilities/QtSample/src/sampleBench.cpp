@@ -0,0 +1,1639 @@
+#include <QCoreApplication>
+#include <qabstracteventdispatcher.h>
+#include <qcommandlineparser.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qeventloop.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qfile.h>
+#include <qmimedata.h>
+#include <qqmlengine.h>
+#include <qjsvalue.h>
+#include <qsortfilterproxymodel.h>
+#include <qthread.h>
+#include <qtimer.h>
+#include "sampleModel.h"
+#include "sampleItem.h"
+#include "sampleTickScheduler.h"
+#include "samplePagedStore.h"
+#include "sampleSortProxy.h"
+#include "sampleGroupProxy.h"
+#include "sampleSearchProxy.h"
+#include "sampleObjectStore.h"
+#include "sampleColumnStore.h"
+#include "sampleTrace.h"
+#include "sampleJournal.h"
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_LINUX)
+#include <fstream>
+#include <unistd.h>
+#endif
+
+/**
+* Headless benchmark of SampleModel
+* Usage: qtSampleBench [--items N] [--json FILE] [operations|bulk|notifications|callbacks|storage|threads...]
+*/
+namespace
+{
+    const int tickAmount = 50;
+    QJsonArray benchResults;
+
+    QString storageName(SampleModel::StorageMode storageMode)
+    {
+        return storageMode == SampleModel::ColumnStorage ? "columns" :
+            storageMode == SampleModel::PagedStorage ? "paged" : "objects";
+    }
+
+    void fillModel(SampleModel& model, int itemAmount, bool start)
+    {
+        for (int i = 0; i < itemAmount; ++i)
+        {
+            model.createItem(("Sample Item " + std::to_string(i)).c_str());
+            if (start)
+            {
+                model.startItemProgress(i);
+            }
+        }
+    }
+
+    /**
+    * Collects latency samples of an operation, each sample timing opsPerSample calls
+    * so that very cheap calls are not dominated by the cost of reading the clock
+    */
+    class LatencyRecorder
+    {
+    public:
+        LatencyRecorder(const QString& name, int opsPerSample = 1)
+            : m_name(name)
+            , m_opsPerSample(opsPerSample)
+        {
+        }
+
+        void start()
+        {
+            m_timer.start();
+        }
+
+        void stop()
+        {
+            m_samples.push_back(m_timer.nsecsElapsed());
+        }
+
+        void report(const QString& storage)
+        {
+            if (m_samples.empty())
+            {
+                return;
+            }
+
+            std::sort(m_samples.begin(), m_samples.end());
+            qint64 totalNs = 0;
+            for (const auto sample : m_samples)
+            {
+                totalNs += sample;
+            }
+
+            const double operations = static_cast<double>(m_samples.size()) * m_opsPerSample;
+            const double throughput = totalNs > 0 ? operations * 1e9 / totalNs : 0.0;
+
+            QJsonObject result;
+            result["suite"] = QString("operations");
+            result["name"] = m_name;
+            result["storage"] = storage;
+            result["operations"] = operations;
+            result["opsPerSecond"] = throughput;
+            result["p50Ns"] = percentile(0.50);
+            result["p90Ns"] = percentile(0.90);
+            result["p99Ns"] = percentile(0.99);
+            result["maxNs"] = percentile(1.0);
+            benchResults.append(result);
+
+            std::cout << m_name.toStdString() << "\t" << storage.toStdString() << "\t"
+                << operations << "\t" << throughput << "\t"
+                << percentile(0.50) << "\t" << percentile(0.90) << "\t"
+                << percentile(0.99) << "\t" << percentile(1.0) << std::endl;
+        }
+
+    private:
+        double percentile(double fraction) const
+        {
+            const size_t index = std::min(m_samples.size() - 1,
+                static_cast<size_t>(fraction * m_samples.size()));
+            return static_cast<double>(m_samples[index]) / m_opsPerSample;
+        }
+
+        QString m_name;
+        int m_opsPerSample;
+        QElapsedTimer m_timer;
+        std::vector<qint64> m_samples;
+    };
+
+    /**
+    * Latency and throughput of each model operation
+    */
+    void benchOperations(SampleModel::StorageMode storageMode, int itemAmount)
+    {
+        const QString storage = storageName(storageMode);
+        std::mt19937 random(1234);
+        SampleModel model(storageMode);
+
+        LatencyRecorder createItem("createItem");
+        for (int i = 0; i < itemAmount; ++i)
+        {
+            const QString name = QString("Sample Item %1").arg(i);
+            createItem.start();
+            model.createItem(name);
+            createItem.stop();
+        }
+        createItem.report(storage);
+
+        LatencyRecorder setData("setData");
+        for (int i = 0; i < itemAmount; ++i)
+        {
+            const QModelIndex index = model.index(static_cast<int>(random() % itemAmount));
+            const QVariant name = QString("Renamed Item %1").arg(i);
+            setData.start();
+            model.setData(index, name, SampleModel::NameRole);
+            setData.stop();
+        }
+        setData.report(storage);
+
+        const auto roleNames = model.roleNames();
+        const int callsPerSample = 100;
+        for (auto itr = roleNames.begin(); itr != roleNames.end(); ++itr)
+        {
+            LatencyRecorder data("data:" + QString::fromUtf8(itr.value()), callsPerSample);
+            for (int sample = 0; sample < 1000; ++sample)
+            {
+                const int first = static_cast<int>(random() % itemAmount);
+                data.start();
+                for (int i = 0; i < callsPerSample; ++i)
+                {
+                    model.data(model.index((first + i) % itemAmount), itr.key());
+                }
+                data.stop();
+            }
+            data.report(storage);
+        }
+
+        LatencyRecorder moveItems("moveItems");
+        for (int i = 0; i < 1000; ++i)
+        {
+            const int oldIndex = static_cast<int>(random() % itemAmount);
+            const int newIndex = static_cast<int>(random() % itemAmount);
+            moveItems.start();
+            model.moveItems(oldIndex, newIndex);
+            moveItems.stop();
+        }
+        moveItems.report(storage);
+
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            model.startItemProgress(row);
+        }
+
+        LatencyRecorder tick("tick");
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            tick.start();
+            model.tick();
+            tick.stop();
+        }
+        tick.report(storage);
+
+        LatencyRecorder deleteItem("deleteItem");
+        while (model.rowCount() > 0)
+        {
+            const int row = static_cast<int>(random() % model.rowCount());
+            deleteItem.start();
+            model.deleteItem(row);
+            deleteItem.stop();
+        }
+        deleteItem.report(storage);
+    }
+
+    /**
+    * Compares loading and starting items one call at a time against the bulk methods
+    */
+    void benchBulk(SampleModel::StorageMode storageMode, int itemAmount)
+    {
+        QElapsedTimer timer;
+        double singleMs = 0.0;
+        double bulkMs = 0.0;
+        int singleSignals = 0;
+        int bulkSignals = 0;
+        {
+            SampleModel model(storageMode);
+            QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&singleSignals]() { ++singleSignals; });
+            QObject::connect(&model, &QAbstractItemModel::dataChanged, [&singleSignals]() { ++singleSignals; });
+            timer.start();
+            fillModel(model, itemAmount, true);
+            singleMs = timer.nsecsElapsed() / 1e6;
+        }
+        {
+            SampleModel model(storageMode);
+            QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&bulkSignals]() { ++bulkSignals; });
+            QObject::connect(&model, &QAbstractItemModel::dataChanged, [&bulkSignals]() { ++bulkSignals; });
+            timer.start();
+            model.createItems(itemAmount, "Sample Item ");
+            model.startItemsInState(SampleItem::NONE);
+            bulkMs = timer.nsecsElapsed() / 1e6;
+        }
+
+        QJsonObject result;
+        result["suite"] = QString("bulk");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["singleMs"] = singleMs;
+        result["singleSignals"] = singleSignals;
+        result["bulkMs"] = bulkMs;
+        result["bulkSignals"] = bulkSignals;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t"
+            << singleMs << "\t" << singleSignals << "\t"
+            << bulkMs << "\t" << bulkSignals << std::endl;
+    }
+
+    /**
+    * Ticks a model where every item is stepping, counting dataChanged emissions
+    */
+    void benchNotifications(int itemAmount, bool batchUpdates)
+    {
+        SampleModel model;
+        model.setBatchUpdates(batchUpdates);
+        fillModel(model, itemAmount, true);
+
+        int signalCount = 0;
+        QObject::connect(&model, &QAbstractItemModel::dataChanged, [&signalCount]() { ++signalCount; });
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+
+        const double microsecondsPerTick = timer.nsecsElapsed() / 1000.0 / tickAmount;
+        const double signalsPerTick = static_cast<double>(signalCount) / tickAmount;
+
+        QJsonObject result;
+        result["suite"] = QString("notifications");
+        result["items"] = itemAmount;
+        result["mode"] = QString(batchUpdates ? "batched" : "immediate");
+        result["signalsPerTick"] = signalsPerTick;
+        result["usPerTick"] = microsecondsPerTick;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t"
+            << (batchUpdates ? "batched" : "immediate") << "\t"
+            << signalsPerTick << "\t"
+            << microsecondsPerTick << std::endl;
+    }
+
+    /**
+    * Measures the cost of a change callback, which has to map the item back to its row
+    */
+    void benchChangeCallback(int itemAmount)
+    {
+        SampleModel model;
+        fillModel(model, itemAmount, false);
+
+        // Spread the changed rows over the whole model
+        const int callbackAmount = 10000;
+        const int stride = std::max(1, itemAmount / callbackAmount);
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < callbackAmount; ++i)
+        {
+            const int row = (i * stride) % itemAmount;
+            model.startItemProgress(row);
+            model.pauseItemProgress(row);
+        }
+        const double nsPerCallback = static_cast<double>(timer.nsecsElapsed()) / (callbackAmount * 2);
+
+        QJsonObject result;
+        result["suite"] = QString("callbacks");
+        result["items"] = itemAmount;
+        result["nsPerCallback"] = nsPerCallback;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << nsPerCallback << std::endl;
+    }
+
+    /**
+    * Returns the resident memory of the process in bytes, or zero if unknown
+    */
+    size_t currentMemoryUsage()
+    {
+#if defined(Q_OS_WIN)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.WorkingSetSize;
+        }
+#elif defined(Q_OS_LINUX)
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        if (statm >> pages >> resident)
+        {
+            return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0;
+    }
+
+    /**
+    * Compares the memory and tick throughput of a storage layout
+    */
+    void benchStorage(SampleModel::StorageMode storageMode, int itemAmount)
+    {
+        double bytesPerRow = 0.0;
+        double rowsTickedPerSecond = 0.0;
+        const size_t memoryBefore = currentMemoryUsage();
+        {
+            SampleModel model(storageMode);
+            fillModel(model, itemAmount, true);
+
+            const size_t memoryAfter = currentMemoryUsage();
+            bytesPerRow = memoryAfter > memoryBefore
+                ? static_cast<double>(memoryAfter - memoryBefore) / itemAmount : 0.0;
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < tickAmount; ++i)
+            {
+                model.tick();
+            }
+            const double seconds = timer.nsecsElapsed() / 1e9;
+            rowsTickedPerSecond = seconds > 0.0 ? itemAmount * tickAmount / seconds : 0.0;
+        }
+
+        QJsonObject result;
+        result["suite"] = QString("storage");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["bytesPerRow"] = bytesPerRow;
+        result["rowsTickedPerSecond"] = rowsTickedPerSecond;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t"
+            << storageName(storageMode).toStdString() << "\t"
+            << bytesPerRow << "\t"
+            << rowsTickedPerSecond << std::endl;
+    }
+
+    /**
+    * Measures the tick time of a large column model for a given amount of threads
+    */
+    double benchTickThreads(int itemAmount, int threadCount)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        model.setTickThreads(threadCount);
+        for (int i = 0; i < itemAmount; ++i)
+        {
+            model.createItem(QString());
+            model.startItemProgress(i);
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+        return timer.nsecsElapsed() / 1e6 / tickAmount;
+    }
+
+    void benchThreads(int itemAmount)
+    {
+        const double serialMs = benchTickThreads(itemAmount, 1);
+        for (int threadCount : { 1, 2, 4, 8, 16, 32 })
+        {
+            const double ms = threadCount == 1 ? serialMs : benchTickThreads(itemAmount, threadCount);
+            const double speedup = ms > 0.0 ? serialMs / ms : 0.0;
+
+            QJsonObject result;
+            result["suite"] = QString("threads");
+            result["items"] = itemAmount;
+            result["threads"] = threadCount;
+            result["msPerTick"] = ms;
+            result["speedup"] = speedup;
+            benchResults.append(result);
+
+            std::cout << itemAmount << "\t" << threadCount << "\t" << ms << "\t" << speedup << std::endl;
+        }
+    }
+
+    /**
+    * Compares the default serializing drag payload with the SampleModel one
+    * for a selection of rows spread over the model, then drops it within the model
+    */
+    void benchDragDrop(SampleModel::StorageMode storageMode, int itemAmount, int selectedAmount)
+    {
+        SampleModel model(storageMode);
+        model.createItems(itemAmount, "Sample Item ");
+
+        QModelIndexList indexes;
+        const int stride = std::max(1, itemAmount / selectedAmount);
+        for (int row = 0; row < itemAmount && indexes.size() < selectedAmount; row += stride)
+        {
+            indexes.push_back(model.index(row));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        std::unique_ptr<QMimeData> defaultData(model.QAbstractItemModel::mimeData(indexes));
+        const double defaultMs = timer.nsecsElapsed() / 1e6;
+        // The default implementation encodes under the first of mimeTypes()
+        const int defaultBytes = defaultData ? defaultData->data(model.mimeTypes().at(0)).size() : 0;
+        if (defaultBytes == 0)
+        {
+            qFatal("The default drag payload is empty");
+        }
+
+        timer.start();
+        std::unique_ptr<QMimeData> sampleData(model.mimeData(indexes));
+        const double dragMs = timer.nsecsElapsed() / 1e6;
+
+        timer.start();
+        const int encodedBytes = sampleData->data(SampleModel::MimeKey).size();
+        const double encodeMs = timer.nsecsElapsed() / 1e6;
+
+        timer.start();
+        model.dropMimeData(sampleData.get(), Qt::MoveAction, 0, 0, QModelIndex());
+        const double dropMs = timer.nsecsElapsed() / 1e6;
+
+        QJsonObject result;
+        result["suite"] = QString("dragdrop");
+        result["items"] = itemAmount;
+        result["selected"] = indexes.size();
+        result["storage"] = storageName(storageMode);
+        result["defaultMs"] = defaultMs;
+        result["defaultBytes"] = defaultBytes;
+        result["dragMs"] = dragMs;
+        result["encodeMs"] = encodeMs;
+        result["encodedBytes"] = encodedBytes;
+        result["dropMs"] = dropMs;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << indexes.size() << "\t" << storageName(storageMode).toStdString() << "\t"
+            << defaultMs << "\t" << defaultBytes << "\t"
+            << dragMs << "\t" << encodeMs << "\t" << encodedBytes << "\t" << dropMs << std::endl;
+    }
+
+    /**
+    * Counts event loop wakeups over a second for a model whose items are all idle,
+    * ticked either by an always running timer or by the idle-aware scheduler
+    */
+    void benchIdleWakeups(int itemAmount, bool useScheduler)
+    {
+        SampleModel model;
+        model.createItems(itemAmount, "Sample Item ");
+
+        QTimer timer;
+        std::unique_ptr<SampleTickScheduler> scheduler;
+        if (useScheduler)
+        {
+            scheduler.reset(new SampleTickScheduler(model));
+        }
+        else
+        {
+            timer.setInterval(10);
+            QObject::connect(&timer, &QTimer::timeout, [&model]() { model.tick(); });
+            timer.start();
+        }
+
+        quint64 wakeups = 0;
+        QEventLoop loop;
+        const auto connection = QObject::connect(QAbstractEventDispatcher::instance(),
+            &QAbstractEventDispatcher::awake, [&wakeups]() { ++wakeups; });
+        QTimer::singleShot(1000, &loop, &QEventLoop::quit);
+        loop.exec();
+        QObject::disconnect(connection);
+
+        QJsonObject result;
+        result["suite"] = QString("idle");
+        result["items"] = itemAmount;
+        result["scheduler"] = QString(useScheduler ? "idle-aware" : "timer");
+        result["wakeupsPerSecond"] = static_cast<double>(wakeups);
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << (useScheduler ? "idle-aware" : "timer") << "\t" << wakeups << std::endl;
+    }
+
+    /**
+    * Reads roles the way a scrolling view does, a window of rows read repeatedly
+    * while it slides over the model, with and without the role value cache
+    */
+    void benchRoles(SampleModel::StorageMode storageMode, int itemAmount, bool cached)
+    {
+        SampleModel model(storageMode);
+        model.setRoleCacheEnabled(cached);
+        model.createItems(itemAmount, "Sample Item ");
+        model.startItemsInState(SampleItem::NONE);
+
+        const int windowRows = 50;
+        const int readsPerWindow = 4;
+        const QString cache = cached ? "cached" : "uncached";
+        const auto roleNames = model.roleNames();
+
+        for (int role = SampleModel::NameRole; role <= SampleModel::MaxStepRole; ++role)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            qint64 calls = 0;
+            for (int first = 0; first + windowRows <= itemAmount; first += windowRows / 2)
+            {
+                for (int read = 0; read < readsPerWindow; ++read)
+                {
+                    for (int row = first; row < first + windowRows; ++row)
+                    {
+                        model.data(model.index(row), role);
+                        ++calls;
+                    }
+                }
+            }
+            const double nsPerCall = static_cast<double>(timer.nsecsElapsed()) / calls;
+
+            QJsonObject result;
+            result["suite"] = QString("roles");
+            result["items"] = itemAmount;
+            result["storage"] = storageName(storageMode);
+            result["cache"] = cache;
+            result["role"] = QString(roleNames.value(role));
+            result["nsPerCall"] = nsPerCall;
+            benchResults.append(result);
+
+            std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t"
+                << cache.toStdString() << "\t" << roleNames.value(role).toStdString() << "\t" << nsPerCall << std::endl;
+        }
+
+        // Every role of a row through separate data() calls against one multiData() call
+        std::vector<SampleModel::RoleData> roleData;
+        for (int role = SampleModel::NameRole; role <= SampleModel::MaxStepRole; ++role)
+        {
+            roleData.push_back({ role, QVariant() });
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            for (const auto& entry : roleData)
+            {
+                model.data(model.index(row), entry.role);
+            }
+        }
+        const double dataNsPerRow = static_cast<double>(timer.nsecsElapsed()) / itemAmount;
+
+        timer.start();
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            model.multiData(model.index(row), roleData);
+        }
+        const double multiDataNsPerRow = static_cast<double>(timer.nsecsElapsed()) / itemAmount;
+
+        QJsonObject result;
+        result["suite"] = QString("roles");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["cache"] = cache;
+        result["role"] = QString("all");
+        result["dataNsPerRow"] = dataNsPerRow;
+        result["multiDataNsPerRow"] = multiDataNsPerRow;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t"
+            << cache.toStdString() << "\tall\t" << dataNsPerRow << "\t" << multiDataNsPerRow << std::endl;
+    }
+
+    /**
+    * Opens a dataset in paged storage and scrolls through all of it the way a view does,
+    * fetching rows at the end and reading a window of them, memory should not grow with rows
+    * Then deletes rows near the top, which only shifts the row index and not the records
+    */
+    void benchPaged(int itemAmount)
+    {
+        const QString path = QDir::temp().filePath("qtSampleBench.dataset");
+        QElapsedTimer timer;
+        timer.start();
+        SamplePagedStore::createDataset(path, itemAmount, "Sample Item ");
+        const double createMs = timer.nsecsElapsed() / 1e6;
+
+        double openMs = 0.0;
+        double scrollMs = 0.0;
+        double removeMs = 0.0;
+        const int removeRows = 100;
+        double bytesPerRow = 0.0;
+        size_t memoryGrowth = 0;
+        {
+            const size_t memoryBefore = currentMemoryUsage();
+            SampleModel model(SampleModel::PagedStorage);
+            timer.start();
+            model.openDataset(path);
+            openMs = timer.nsecsElapsed() / 1e6;
+
+            const int windowRows = 50;
+            timer.start();
+            for (int first = 0; first < itemAmount; first += windowRows)
+            {
+                while (first + windowRows > model.rowCount() && model.canFetchMore(QModelIndex()))
+                {
+                    model.fetchMore(QModelIndex());
+                }
+                const int last = std::min(first + windowRows, model.rowCount());
+                for (int row = first; row < last; ++row)
+                {
+                    model.data(model.index(row), SampleModel::NameRole);
+                    model.data(model.index(row), SampleModel::StepRole);
+                }
+            }
+            scrollMs = timer.nsecsElapsed() / 1e6;
+
+            timer.start();
+            for (int i = 0; i < removeRows && model.rowCount() > 1; ++i)
+            {
+                model.deleteItem(1);
+            }
+            removeMs = timer.nsecsElapsed() / 1e6;
+
+            const size_t memoryAfter = currentMemoryUsage();
+            memoryGrowth = memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+            bytesPerRow = static_cast<double>(memoryGrowth) / itemAmount;
+        }
+        QFile::remove(path);
+
+        QJsonObject result;
+        result["suite"] = QString("paged");
+        result["items"] = itemAmount;
+        result["createMs"] = createMs;
+        result["openMs"] = openMs;
+        result["scrollMs"] = scrollMs;
+        result["removeRows"] = removeRows;
+        result["removeMs"] = removeMs;
+        result["memoryGrowthBytes"] = static_cast<double>(memoryGrowth);
+        result["bytesPerRow"] = bytesPerRow;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << createMs << "\t" << openMs << "\t" << scrollMs << "\t"
+            << memoryGrowth << "\t" << bytesPerRow << std::endl;
+    }
+
+    /**
+    * Ticks a model with half of its items stepping while a proxy keeps it ordered by step,
+    * the incremental proxy against QSortFilterProxyModel with dynamic sorting
+    */
+    void benchSort(int itemAmount, bool incremental)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        model.createItems(itemAmount, "Sample Item ");
+
+        std::unique_ptr<QAbstractProxyModel> proxy;
+        if (incremental)
+        {
+            auto* sortProxy = new SampleSortProxy();
+            sortProxy->setSortRole(SampleModel::StepRole);
+            sortProxy->setSortOrder(Qt::DescendingOrder);
+            proxy.reset(sortProxy);
+        }
+        else
+        {
+            auto* sortProxy = new QSortFilterProxyModel();
+            sortProxy->setDynamicSortFilter(true);
+            sortProxy->setSortRole(SampleModel::StepRole);
+            sortProxy->sort(0, Qt::DescendingOrder);
+            proxy.reset(sortProxy);
+        }
+        proxy->setSourceModel(&model);
+
+        // Stagger the start of the stepping items so their steps differ
+        QList<int> rows;
+        for (int row = 0; row < itemAmount; row += 2)
+        {
+            rows.push_back(row);
+            if (rows.size() == itemAmount / 20)
+            {
+                model.startItems(rows);
+                model.tick();
+                rows.clear();
+            }
+        }
+        model.startItems(rows);
+
+        const int sortTicks = 20;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < sortTicks; ++i)
+        {
+            model.tick();
+        }
+        const double microsecondsPerTick = timer.nsecsElapsed() / 1000.0 / sortTicks;
+
+        QJsonObject result;
+        result["suite"] = QString("sort");
+        result["items"] = itemAmount;
+        result["proxy"] = QString(incremental ? "incremental" : "QSortFilterProxyModel");
+        result["usPerTick"] = microsecondsPerTick;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << (incremental ? "incremental" : "QSortFilterProxyModel") << "\t"
+            << microsecondsPerTick << std::endl;
+    }
+
+    /**
+    * Grouping a large model and expanding one group, the proxy only assigns rows to groups
+    * until a group is fetched, then ticks with the expanded group regrouping completed rows
+    */
+    void benchGroup(int itemAmount, SampleGroupProxy::GroupBy groupBy)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        for (int prefix = 0; prefix < 10; ++prefix)
+        {
+            model.createItems(itemAmount / 10, QString("Batch %1 Item ").arg(prefix));
+        }
+        QList<int> rows;
+        for (int row = 0; row < itemAmount; row += 2)
+        {
+            rows.append(row);
+        }
+        model.startItems(rows);
+
+        QElapsedTimer timer;
+        timer.start();
+        SampleGroupProxy proxy;
+        proxy.setGroupBy(groupBy);
+        proxy.setSourceModel(&model);
+        const double groupMs = timer.nsecsElapsed() / 1e6;
+
+        // Expand the largest group, as a view would on the first click
+        int largest = 0;
+        for (int group = 1; group < proxy.groupCount(); ++group)
+        {
+            largest = proxy.groupRowCount(group) > proxy.groupRowCount(largest) ? group : largest;
+        }
+        timer.start();
+        proxy.fetchMore(proxy.index(largest, 0));
+        const double expandMs = timer.nsecsElapsed() / 1e6;
+
+        const int tickAmount = 20;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+        const double tickMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+
+        const QString grouping = groupBy == SampleGroupProxy::GroupByState ? "state" : "name prefix";
+        QJsonObject result;
+        result["suite"] = QString("group");
+        result["items"] = itemAmount;
+        result["groupBy"] = grouping;
+        result["groups"] = proxy.groupCount();
+        result["groupMs"] = groupMs;
+        result["expandMs"] = expandMs;
+        result["tickMs"] = tickMs;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << grouping.toStdString() << "\t" << proxy.groupCount() << "\t"
+            << groupMs << "\t" << expandMs << "\t" << tickMs << std::endl;
+    }
+
+    /**
+    * Type-ahead filtering of the names, each keystroke of the query is applied to the
+    * proxy as a view would, the fixed string filter of QSortFilterProxyModel scans every
+    * name per keystroke where the indexed proxy only verifies the rows its index finds
+    */
+    void benchSearch(int itemAmount, bool indexed)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        model.createItems(itemAmount, "Sample Item ");
+
+        QElapsedTimer timer;
+        timer.start();
+        std::unique_ptr<QAbstractProxyModel> proxy;
+        SampleSearchProxy* searchProxy = nullptr;
+        QSortFilterProxyModel* filterProxy = nullptr;
+        if (indexed)
+        {
+            searchProxy = new SampleSearchProxy();
+            proxy.reset(searchProxy);
+        }
+        else
+        {
+            filterProxy = new QSortFilterProxyModel();
+            filterProxy->setFilterRole(SampleModel::NameRole);
+            filterProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+            proxy.reset(filterProxy);
+        }
+        proxy->setSourceModel(&model);
+        const double buildMs = timer.nsecsElapsed() / 1e6;
+
+        const QString query = QString("item %1").arg(itemAmount / 2 + 123);
+        double queryMs = 0;
+        for (int length = 1; length <= query.size(); ++length)
+        {
+            timer.start();
+            if (indexed)
+            {
+                searchProxy->setQuery(query.left(length));
+            }
+            else
+            {
+                filterProxy->setFilterFixedString(query.left(length));
+            }
+            queryMs += timer.nsecsElapsed() / 1e6;
+        }
+        const double keystrokeMs = queryMs / query.size();
+        const int matches = proxy->rowCount();
+
+        // Renaming rows keeps the index current as they are edited
+        const int renameAmount = 1000;
+        timer.start();
+        for (int i = 0; i < renameAmount; ++i)
+        {
+            model.setData(model.index(i * (itemAmount / renameAmount)), QString("Renamed Item %1").arg(i), SampleModel::NameRole);
+        }
+        const double renameUs = timer.nsecsElapsed() / 1e3 / renameAmount;
+
+        const QString proxyName = indexed ? "indexed" : "QSortFilterProxyModel";
+        QJsonObject result;
+        result["suite"] = QString("search");
+        result["items"] = itemAmount;
+        result["proxy"] = proxyName;
+        result["buildMs"] = buildMs;
+        result["keystrokeMs"] = keystrokeMs;
+        result["matches"] = matches;
+        result["renameUs"] = renameUs;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << proxyName.toStdString() << "\t" << buildMs << "\t" << keystrokeMs << "\t"
+            << matches << "\t" << renameUs << std::endl;
+    }
+
+    /**
+    * Ticks a store with a small fraction of its rows stepping, visiting only the active set
+    * against scanning every row as ticking did before, only the first should grow with
+    * the stepping rows rather than with all of them
+    */
+    void benchActiveTick(SampleModel::StorageMode storageMode, int itemAmount, int activePercent)
+    {
+        std::unique_ptr<SampleStore> store;
+        if (storageMode == SampleModel::ColumnStorage)
+        {
+            store.reset(new SampleColumnStore());
+        }
+        else
+        {
+            store.reset(new SampleObjectStore());
+        }
+
+        // Spread the stepping rows out and give them room so none complete while measuring
+        store->reserve(itemAmount);
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            store->append(QString());
+        }
+        const int stride = 100 / activePercent;
+        for (int row = 0; row < itemAmount; row += stride)
+        {
+            store->setMaxSteps(row, 1000000);
+            store->setStepRate(row, 1 + row % 3);
+            store->setState(row, SampleItem::STEPPING);
+        }
+
+        const int tickAmount = 50;
+        SampleDirtyTracker dirtyRows;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            store->tick(0, itemAmount - 1, dirtyRows);
+            dirtyRows.clear();
+        }
+        const double scanMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            store->tickActiveRows(dirtyRows);
+            dirtyRows.clear();
+        }
+        const double activeMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+
+        QJsonObject result;
+        result["suite"] = QString("active");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["activeRows"] = store->activeCount();
+        result["scanMs"] = scanMs;
+        result["activeMs"] = activeMs;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t"
+            << store->activeCount() << "\t" << scanMs << "\t" << activeMs << std::endl;
+    }
+
+    /**
+    * Element access from JS, typed lists read one element per access while the whole
+    * list properties they replaced are converted on every access, so the legacy lists
+    * are only sampled for a few accesses and compared per access
+    */
+    void benchListAccess(int itemAmount)
+    {
+        SampleModel model;
+        model.fillTestItems(itemAmount);
+        Test::LegacyLists legacy;
+        legacy.fill(itemAmount);
+
+        QQmlEngine engine;
+        QQmlEngine::setObjectOwnership(&model, QQmlEngine::CppOwnership);
+        QQmlEngine::setObjectOwnership(&legacy, QQmlEngine::CppOwnership);
+        engine.globalObject().setProperty("model", engine.newQObject(&model));
+        engine.globalObject().setProperty("legacy", engine.newQObject(&legacy));
+
+        struct Access
+        {
+            const char* list;
+            const char* exposure;
+            const char* expression;
+            int count;
+        };
+
+        const int legacyAccesses = 100;
+        const Access accesses[] =
+        {
+            { "int", "legacy", "legacy.intList[i]", legacyAccesses },
+            { "int", "typed", "model.intListTest.at(i)", itemAmount },
+            { "color", "legacy", "legacy.colorList[i]", legacyAccesses },
+            { "color", "typed", "model.colorListTest.at(i)", itemAmount },
+            { "object", "legacy", "legacy.objectList[i].id", legacyAccesses },
+            { "object", "typed", "model.objectListTest[i].id", itemAmount },
+        };
+
+        for (const auto& access : accesses)
+        {
+            QJSValue read = engine.evaluate(QString(
+                "(function(n) { var found = 0; for (var i = 0; i < n; ++i) { if (%1 !== undefined) ++found; } return found; })")
+                .arg(access.expression));
+
+            QElapsedTimer timer;
+            timer.start();
+            const QJSValue found = read.call(QJSValueList{ access.count });
+            const double nsPerAccess = static_cast<double>(timer.nsecsElapsed()) / access.count;
+
+            QJsonObject result;
+            result["suite"] = QString("lists");
+            result["items"] = itemAmount;
+            result["list"] = QString(access.list);
+            result["exposure"] = QString(access.exposure);
+            result["accesses"] = access.count;
+            result["found"] = found.toInt();
+            result["nsPerAccess"] = nsPerAccess;
+            benchResults.append(result);
+
+            std::cout << itemAmount << "\t" << access.list << "\t" << access.exposure << "\t"
+                << access.count << "\t" << nsPerAccess << std::endl;
+        }
+    }
+
+    /**
+    * Calls each way of returning test objects from a tight JS loop, then collects garbage,
+    * counting the Test::Objects allocated and timing the loop and the collection pause
+    */
+    void benchReturns(int callAmount)
+    {
+        SampleModel model;
+        QQmlEngine engine;
+        QQmlEngine::setObjectOwnership(&model, QQmlEngine::CppOwnership);
+        engine.globalObject().setProperty("model", engine.newQObject(&model));
+
+        struct Call
+        {
+            const char* name;
+            const char* statement;
+        };
+
+        const Call calls[] =
+        {
+            { "object", "sum += model.returnObject().id;" },
+            { "objectList", "sum += model.returnObjectList()[0].id;" },
+            { "gadget", "sum += model.returnGadget(i).id;" },
+            { "pooled", "var o = model.acquireObject(i); sum += o.id; model.releaseObject(o);" },
+            { "pooledList", "var l = model.acquireObjectList(1, i); sum += l[0].id; model.releaseObjectList(l);" },
+        };
+
+        // Test::Objects with JS ownership are deleted by the engine through deleteLater,
+        // which only happens once the deferred deletes are sent
+        for (const auto& call : calls)
+        {
+            engine.collectGarbage();
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+            QJSValue loop = engine.evaluate(QString(
+                "(function(n) { var sum = 0; for (var i = 0; i < n; ++i) { %1 } return sum; })").arg(call.statement));
+
+            const quint64 allocationsBefore = Test::Object::allocationCount();
+            const size_t memoryBefore = currentMemoryUsage();
+            QElapsedTimer timer;
+            timer.start();
+            loop.call(QJSValueList{ callAmount });
+            const double loopMs = timer.nsecsElapsed() / 1e6;
+            const size_t memoryAfter = currentMemoryUsage();
+            const quint64 allocations = Test::Object::allocationCount() - allocationsBefore;
+
+            timer.start();
+            engine.collectGarbage();
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+            const double gcMs = timer.nsecsElapsed() / 1e6;
+
+            QJsonObject result;
+            result["suite"] = QString("returns");
+            result["calls"] = callAmount;
+            result["return"] = QString(call.name);
+            result["loopMs"] = loopMs;
+            result["gcMs"] = gcMs;
+            result["allocations"] = static_cast<double>(allocations);
+            result["liveObjects"] = static_cast<double>(Test::Object::liveCount());
+            result["memoryGrowth"] = static_cast<double>(memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0);
+            benchResults.append(result);
+
+            std::cout << callAmount << "\t" << call.name << "\t" << loopMs << "\t" << gcMs << "\t"
+                << allocations << "\t" << Test::Object::liveCount() << std::endl;
+        }
+    }
+
+    /**
+    * Cost of recording metrics on the hottest paths, ticks and data() calls,
+    * with recording disabled it should match a build without SAMPLE_METRICS
+    */
+    void benchMetrics(int itemAmount, bool enabled)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        model.setRoleCacheEnabled(false);
+        model.metrics()->setEnabled(enabled);
+        model.createItems(itemAmount, "Sample Item ");
+        model.startItemsInState(SampleItem::NONE);
+
+        const int tickAmount = 100;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+        const double tickMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+
+        timer.start();
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            model.data(model.index(row), SampleModel::StepRole);
+        }
+        const double dataNsPerCall = static_cast<double>(timer.nsecsElapsed()) / itemAmount;
+
+        const QString recording = !SampleMetrics::isAvailable() ? "compiled out" : enabled ? "enabled" : "disabled";
+        QJsonObject result;
+        result["suite"] = QString("metrics");
+        result["items"] = itemAmount;
+        result["recording"] = recording;
+        result["tickMs"] = tickMs;
+        result["dataNsPerCall"] = dataNsPerCall;
+        if (enabled)
+        {
+            result["metrics"] = model.metrics()->toJson();
+        }
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << recording.toStdString() << "\t" << tickMs << "\t" << dataNsPerCall << std::endl;
+    }
+
+    /**
+    * Summarizing the rows by scanning them through data() against reading the statistics
+    * the store keeps, along with the tick time that includes keeping them
+    */
+    void benchSummary(SampleModel::StorageMode storageMode, int itemAmount)
+    {
+        SampleModel model(storageMode);
+        model.setRoleCacheEnabled(false);
+        model.createItems(itemAmount, "Sample Item ");
+        QList<int> rows;
+        for (int row = 0; row < itemAmount; row += 2)
+        {
+            rows.append(row);
+        }
+        model.startItems(rows);
+
+        const int tickAmount = 20;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+        const double tickMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+
+        timer.start();
+        qint64 scanStepping = 0;
+        qint64 scanSteps = 0;
+        for (int row = 0; row < itemAmount; ++row)
+        {
+            const QModelIndex index = model.index(row);
+            scanStepping += model.data(index, SampleModel::StateValueRole).toInt() == SampleItem::STEPPING ? 1 : 0;
+            scanSteps += model.data(index, SampleModel::StepRole).toInt();
+        }
+        const double scanMs = timer.nsecsElapsed() / 1e6;
+
+        const int readAmount = 100000;
+        const SampleSummary* summary = model.summary();
+        qint64 sum = 0;
+        timer.start();
+        for (int i = 0; i < readAmount; ++i)
+        {
+            sum += summary->steppingCount() + summary->totalSteps();
+        }
+        const double summaryNs = static_cast<double>(timer.nsecsElapsed()) / readAmount;
+
+        if (scanStepping != summary->steppingCount() || scanSteps != summary->totalSteps())
+        {
+            std::cerr << "Summary does not match the rows" << std::endl;
+        }
+
+        QJsonObject result;
+        result["suite"] = QString("summary");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["scanMs"] = scanMs;
+        result["summaryNs"] = summaryNs;
+        result["tickMs"] = tickMs;
+        result["checksum"] = sum;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t" << scanMs << "\t"
+            << summaryNs << "\t" << tickMs << std::endl;
+    }
+
+    /**
+    * Cost of a trace scope on its own and of tracing ticks with their change notifications,
+    * with recording stopped it should match a build without SAMPLE_TRACE
+    */
+    void benchTrace(int itemAmount, bool enabled)
+    {
+        SampleModel model(SampleModel::ColumnStorage);
+        model.createItems(itemAmount, "Sample Item ");
+        model.startItemsInState(SampleItem::NONE);
+        if (enabled)
+        {
+            SampleTrace::start();
+        }
+
+        const int scopeAmount = 1000000;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < scopeAmount; ++i)
+        {
+            SAMPLE_TRACE_SCOPE("bench", "scope");
+        }
+        const double scopeNs = static_cast<double>(timer.nsecsElapsed()) / scopeAmount;
+
+        const int tickAmount = 100;
+        timer.start();
+        for (int i = 0; i < tickAmount; ++i)
+        {
+            model.tick();
+        }
+        const double tickMs = timer.nsecsElapsed() / 1e6 / tickAmount;
+        SampleTrace::stop();
+
+        const QString recording = !SampleTrace::isAvailable() ? "compiled out" : enabled ? "enabled" : "disabled";
+        QJsonObject result;
+        result["suite"] = QString("trace");
+        result["items"] = itemAmount;
+        result["recording"] = recording;
+        result["scopeNs"] = scopeNs;
+        result["tickMs"] = tickMs;
+        result["events"] = static_cast<qint64>(SampleTrace::eventCount());
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << recording.toStdString() << "\t" << scopeNs << "\t" << tickMs << std::endl;
+    }
+
+    /**
+    * Replays a journal recorded with qtSample --journal, as fast as possible or at the
+    * pace it was recorded, and times the calls of every operation
+    */
+    bool benchReplay(const QString& path, bool originalSpeed)
+    {
+        SampleJournalReader reader;
+        if (!reader.open(path))
+        {
+            std::cerr << "Unable to open journal " << path.toStdString() << std::endl;
+            return false;
+        }
+
+        // Paged rows are not part of the journal, their calls replay against column storage
+        const auto storageMode = reader.storageMode() == SampleModel::ObjectStorage ?
+            SampleModel::ObjectStorage : SampleModel::ColumnStorage;
+        SampleModel model(storageMode);
+
+        SampleHistogram histograms[SampleJournal::OpCount];
+        SampleJournal::Entry entry;
+        quint64 rejected = 0;
+        qint64 busyNs = 0;
+        QElapsedTimer wallTimer;
+        QElapsedTimer callTimer;
+        wallTimer.start();
+        while (reader.next(entry))
+        {
+            if (originalSpeed)
+            {
+                const qint64 waitUs = entry.timeUs - wallTimer.nsecsElapsed() / 1000;
+                if (waitUs > 0)
+                {
+                    QThread::usleep(static_cast<unsigned long>(waitUs));
+                }
+            }
+
+            callTimer.start();
+            if (!model.replay(entry))
+            {
+                ++rejected;
+                continue;
+            }
+            const qint64 callNs = callTimer.nsecsElapsed();
+            histograms[entry.op].record(static_cast<quint64>(callNs));
+            busyNs += callNs;
+        }
+        const double wallMs = wallTimer.nsecsElapsed() / 1e6;
+
+        const QString speed = originalSpeed ? "original" : "maximum";
+        QJsonArray operations;
+        for (int op = 0; op < SampleJournal::OpCount; ++op)
+        {
+            const SampleHistogram& histogram = histograms[op];
+            if (histogram.count() == 0)
+            {
+                continue;
+            }
+
+            const char* name = SampleJournal::opName(static_cast<SampleJournal::Op>(op));
+            QJsonObject operation = histogram.toJson();
+            operation["operation"] = QString(name);
+            operations.append(operation);
+
+            std::cout << name << "\t" << histogram.count() << "\t" << histogram.sum() / 1e6 << "\t"
+                << histogram.average() / 1e3 << "\t" << histogram.percentile(0.95) / 1e3 << "\t"
+                << histogram.max() / 1e3 << std::endl;
+        }
+
+        QJsonObject result;
+        result["suite"] = QString("replay");
+        result["journal"] = path;
+        result["speed"] = speed;
+        result["storage"] = storageName(storageMode);
+        result["wallMs"] = wallMs;
+        result["busyMs"] = busyNs / 1e6;
+        result["rejected"] = static_cast<qint64>(rejected);
+        result["rows"] = model.rowCount();
+        result["operations"] = operations;
+        benchResults.append(result);
+
+        std::cout << "total\t" << speed.toStdString() << " speed\twall " << wallMs << " ms\tbusy " << busyNs / 1e6
+            << " ms\trejected " << rejected << "\trows " << model.rowCount() << std::endl;
+        return true;
+    }
+
+    /**
+    * Time to a populated model, replaying createItems against restoring a snapshot
+    */
+    void benchStartup(SampleModel::StorageMode storageMode, int itemAmount)
+    {
+        const QString path = QDir::temp().filePath("qtSampleBench.snapshot");
+        QElapsedTimer timer;
+
+        double replayMs = 0.0;
+        double saveMs = 0.0;
+        {
+            SampleModel model(storageMode);
+            timer.start();
+            for (int i = 0; i < itemAmount; ++i)
+            {
+                model.createItem(QString("Sample Item %1").arg(i));
+            }
+            replayMs = timer.nsecsElapsed() / 1e6;
+            model.setItemStepRate(0, 3);
+
+            timer.start();
+            model.saveSnapshot(path);
+            saveMs = timer.nsecsElapsed() / 1e6;
+        }
+
+        double restoreMs = 0.0;
+        {
+            SampleModel model(storageMode);
+            timer.start();
+            model.restoreSnapshot(path);
+            restoreMs = timer.nsecsElapsed() / 1e6;
+
+            // Names read before restoring again must outlive the first snapshot,
+            // and saving over the file restored from must replace it, as --snapshot does on exit
+            const QString firstName = model.store().name(0);
+            if (!model.restoreSnapshot(path) || model.store().count() != itemAmount)
+            {
+                qFatal("Restoring the snapshot again failed");
+            }
+            if (firstName != QString("Sample Item 0"))
+            {
+                qFatal("A restored name did not outlive its snapshot");
+            }
+            if (model.store().stepRate(0) != 3)
+            {
+                qFatal("The restored snapshot lost the step rates");
+            }
+            if (!model.saveSnapshot(path))
+            {
+                qFatal("Saving over the restored snapshot failed");
+            }
+        }
+        QFile::remove(path);
+
+        QJsonObject result;
+        result["suite"] = QString("startup");
+        result["items"] = itemAmount;
+        result["storage"] = storageName(storageMode);
+        result["replayMs"] = replayMs;
+        result["saveMs"] = saveMs;
+        result["restoreMs"] = restoreMs;
+        benchResults.append(result);
+
+        std::cout << itemAmount << "\t" << storageName(storageMode).toStdString() << "\t"
+            << replayMs << "\t" << saveMs << "\t" << restoreMs << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless SampleModel benchmark");
+    parser.addHelpOption();
+    QCommandLineOption itemsOption("items", "Number of items for the operations suite", "count", "10000");
+    QCommandLineOption jsonOption("json", "File to write the results to", "file", "qtSampleBench.json");
+    QCommandLineOption journalOption("journal", "Journal recorded with qtSample --journal for the replay suite", "file");
+    QCommandLineOption originalSpeedOption("original-speed", "Replay the journal at the pace it was recorded");
+    parser.addOption(itemsOption);
+    parser.addOption(jsonOption);
+    parser.addOption(journalOption);
+    parser.addOption(originalSpeedOption);
+    parser.addPositionalArgument("suites", "Suites to run, all if none are given, only replay if a journal is given");
+    parser.process(app);
+
+    QStringList suites = parser.positionalArguments();
+    if (suites.isEmpty() && parser.isSet(journalOption))
+    {
+        suites.append("replay");
+    }
+    const auto runSuite = [&suites](const char* suite) { return suites.isEmpty() || suites.contains(suite); };
+    const int itemAmount = std::max(1, parser.value(itemsOption).toInt());
+
+    if (runSuite("operations"))
+    {
+        std::cout << "operation\tstorage\tcalls\tops/s\tp50 ns\tp90 ns\tp99 ns\tmax ns" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchOperations(storageMode, itemAmount);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("bulk"))
+    {
+        std::cout << "items\tstorage\tsingle ms\tsingle signals\tbulk ms\tbulk signals" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchBulk(storageMode, 100000);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("notifications"))
+    {
+        std::cout << "items\tmode\tsignals/tick\tus/tick" << std::endl;
+        for (int amount : { 100, 1000, 10000 })
+        {
+            for (bool batchUpdates : { false, true })
+            {
+                benchNotifications(amount, batchUpdates);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("callbacks"))
+    {
+        std::cout << "items\tns/callback" << std::endl;
+        for (int amount : { 1000, 10000, 100000, 1000000 })
+        {
+            benchChangeCallback(amount);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("storage"))
+    {
+        std::cout << "items\tstorage\tbytes/row\trows ticked/s" << std::endl;
+        for (int amount : { 100000, 1000000 })
+        {
+            for (auto storageMode : { SampleModel::ColumnStorage, SampleModel::ObjectStorage })
+            {
+                benchStorage(storageMode, amount);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("threads"))
+    {
+        std::cout << "items\tthreads\tms/tick\tspeedup" << std::endl;
+        benchThreads(2000000);
+        std::cout << std::endl;
+    }
+
+    if (runSuite("dragdrop"))
+    {
+        std::cout << "items\tselected\tstorage\tdefault ms\tdefault bytes\tdrag ms\tencode ms\tencoded bytes\tdrop ms" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchDragDrop(storageMode, 100000, 5000);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("roles"))
+    {
+        std::cout << "items\tstorage\tcache\trole\tns/call (all: data ns/row, multiData ns/row)" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            for (bool cached : { false, true })
+            {
+                benchRoles(storageMode, 100000, cached);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("paged"))
+    {
+        std::cout << "items\tcreate ms\topen ms\tscroll ms\tmemory growth\tbytes/row" << std::endl;
+        for (int amount : { 1000000, 4000000 })
+        {
+            benchPaged(amount);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("sort"))
+    {
+        std::cout << "items\tproxy\tus/tick" << std::endl;
+        for (int amount : { 10000, 100000 })
+        {
+            for (bool incremental : { false, true })
+            {
+                benchSort(amount, incremental);
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("group"))
+    {
+        std::cout << "items\tgroup by\tgroups\tgroup ms\texpand ms\ttick ms" << std::endl;
+        for (auto groupBy : { SampleGroupProxy::GroupByState, SampleGroupProxy::GroupByNamePrefix })
+        {
+            benchGroup(1000000, groupBy);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("search"))
+    {
+        std::cout << "items\tproxy\tbuild ms\tkeystroke ms\tmatches\trename us" << std::endl;
+        for (bool indexed : { false, true })
+        {
+            benchSearch(1000000, indexed);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("startup"))
+    {
+        std::cout << "items\tstorage\treplay ms\tsave ms\trestore ms" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchStartup(storageMode, 1000000);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("active"))
+    {
+        std::cout << "items\tstorage\tactive rows\tscan ms\tactive ms" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchActiveTick(storageMode, 1000000, 5);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("lists"))
+    {
+        std::cout << "items\tlist\texposure\taccesses\tns per access" << std::endl;
+        benchListAccess(1000000);
+        std::cout << std::endl;
+    }
+
+    if (runSuite("returns"))
+    {
+        std::cout << "calls\treturn\tloop ms\tgc ms\tallocations\tlive objects" << std::endl;
+        benchReturns(100000);
+        std::cout << std::endl;
+    }
+
+    if (runSuite("metrics"))
+    {
+        std::cout << "items\trecording\ttick ms\tdata ns" << std::endl;
+        for (bool enabled : { false, true })
+        {
+            benchMetrics(100000, enabled);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("trace"))
+    {
+        std::cout << "items\trecording\tscope ns\ttick ms" << std::endl;
+        for (bool enabled : { false, true })
+        {
+            benchTrace(100000, enabled);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("summary"))
+    {
+        std::cout << "items\tstorage\tscan ms\tsummary ns\ttick ms" << std::endl;
+        for (auto storageMode : { SampleModel::ObjectStorage, SampleModel::ColumnStorage })
+        {
+            benchSummary(storageMode, 1000000);
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("replay") && parser.isSet(journalOption))
+    {
+        std::cout << "operation\tcalls\ttotal ms\tavg us\tp95 us\tmax us" << std::endl;
+        if (!benchReplay(parser.value(journalOption), parser.isSet(originalSpeedOption)))
+        {
+            return 1;
+        }
+        std::cout << std::endl;
+    }
+
+    if (runSuite("idle"))
+    {
+        std::cout << "items\tscheduler\twakeups/s" << std::endl;
+        for (bool useScheduler : { false, true })
+        {
+            benchIdleWakeups(1000, useScheduler);
+        }
+        std::cout << std::endl;
+    }
+
+    QJsonObject root;
+    root["benchmark"] = QString("qtSampleBench");
+    root["items"] = itemAmount;
+    root["results"] = benchResults;
+
+    QFile file(parser.value(jsonOption));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        std::cerr << "Unable to write " << file.fileName().toStdString() << std::endl;
+        return 1;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return 0;
+}
@@ -0,0 +1,346 @@
+#include "sampleColumnStore.h"
+#include "sampleDirtyTracker.h"
+#include "sampleSnapshot.h"
+#include <qfileinfo.h>
+#include <algorithm>
+
+SampleColumnStore::SampleColumnStore() = default;
+SampleColumnStore::~SampleColumnStore() = default;
+
+int SampleColumnStore::count() const
+{
+    return static_cast<int>(m_states.size());
+}
+
+QString SampleColumnStore::name(int row) const
+{
+    const int handle = m_nameHandles[row];
+    return handle >= 0 ? m_namePool[handle] : m_snapshot->name(-handle - 1);
+}
+
+SampleItem::State SampleColumnStore::state(int row) const
+{
+    return static_cast<SampleItem::State>(m_states[row]);
+}
+
+int SampleColumnStore::step(int row) const
+{
+    return m_steps[row];
+}
+
+int SampleColumnStore::maxSteps(int row) const
+{
+    return m_maxSteps[row];
+}
+
+int SampleColumnStore::stepRate(int row) const
+{
+    return m_stepRates[row];
+}
+
+quint32 SampleColumnStore::id(int row) const
+{
+    return m_ids[row];
+}
+
+void SampleColumnStore::setName(int row, const QString& name)
+{
+    if (m_nameHandles[row] >= 0)
+    {
+        m_namePool[m_nameHandles[row]] = name;
+    }
+    else
+    {
+        m_nameHandles[row] = acquireName(name);
+    }
+    rowChanged(row, SampleItem::NameChange);
+}
+
+void SampleColumnStore::setState(int row, SampleItem::State state)
+{
+    if (m_states[row] != state)
+    {
+        m_stats.changeRow(this->state(row), m_steps[row], m_maxSteps[row], state, m_steps[row], m_maxSteps[row]);
+        m_states[row] = static_cast<uint8_t>(state);
+        if (state == SampleItem::STEPPING)
+        {
+            insertActive(row);
+        }
+        else
+        {
+            removeActive(row);
+        }
+        rowChanged(row, SampleItem::StateChange);
+    }
+}
+
+void SampleColumnStore::setStep(int row, int step)
+{
+    if (m_steps[row] != step)
+    {
+        m_stats.changeRow(state(row), m_steps[row], m_maxSteps[row], state(row), step, m_maxSteps[row]);
+        m_steps[row] = step;
+        rowChanged(row, SampleItem::StepChange);
+    }
+}
+
+void SampleColumnStore::setMaxSteps(int row, int maxSteps)
+{
+    if (m_maxSteps[row] != maxSteps)
+    {
+        m_stats.changeRow(state(row), m_steps[row], m_maxSteps[row], state(row), m_steps[row], maxSteps);
+        m_maxSteps[row] = maxSteps;
+        rowChanged(row, SampleItem::MaxStepChange);
+    }
+}
+
+void SampleColumnStore::setStepRate(int row, int stepRate)
+{
+    m_stepRates[row] = stepRate;
+}
+
+void SampleColumnStore::append(const QString& name)
+{
+    m_states.push_back(SampleItem::NONE);
+    m_steps.push_back(0);
+    m_maxSteps.push_back(SampleItem::DefaultMaxSteps);
+    m_stepRates.push_back(1);
+    m_nameHandles.push_back(acquireName(name));
+    m_ids.push_back(m_nextId++);
+    m_activeSlots.push_back(-1);
+    m_stats.addRow(SampleItem::NONE, 0, SampleItem::DefaultMaxSteps);
+}
+
+void SampleColumnStore::reserve(int count)
+{
+    m_states.reserve(count);
+    m_steps.reserve(count);
+    m_maxSteps.reserve(count);
+    m_stepRates.reserve(count);
+    m_nameHandles.reserve(count);
+    m_ids.reserve(count);
+    m_activeSlots.reserve(count);
+}
+
+void SampleColumnStore::remove(int row, int count)
+{
+    for (int i = row; i < row + count; ++i)
+    {
+        releaseName(m_nameHandles[i]);
+        removeActive(i);
+        m_stats.removeRow(state(i), m_steps[i], m_maxSteps[i]);
+    }
+    m_states.erase(m_states.begin() + row, m_states.begin() + row + count);
+    m_steps.erase(m_steps.begin() + row, m_steps.begin() + row + count);
+    m_maxSteps.erase(m_maxSteps.begin() + row, m_maxSteps.begin() + row + count);
+    m_nameHandles.erase(m_nameHandles.begin() + row, m_nameHandles.begin() + row + count);
+    m_stepRates.erase(m_stepRates.begin() + row, m_stepRates.begin() + row + count);
+    m_ids.erase(m_ids.begin() + row, m_ids.begin() + row + count);
+    m_activeSlots.erase(m_activeSlots.begin() + row, m_activeSlots.begin() + row + count);
+    updateActiveRows(row, this->count() - 1);
+}
+
+void SampleColumnStore::move(int from, int count, int to)
+{
+    moveElements(m_states, from, count, to);
+    moveElements(m_steps, from, count, to);
+    moveElements(m_maxSteps, from, count, to);
+    moveElements(m_nameHandles, from, count, to);
+    moveElements(m_stepRates, from, count, to);
+    moveElements(m_ids, from, count, to);
+    moveElements(m_activeSlots, from, count, to);
+    updateActiveRows(std::min(from, to), std::max(from, to) + count - 1);
+}
+
+void SampleColumnStore::tick(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        if (m_states[row] == SampleItem::STEPPING)
+        {
+            stepRow(row, dirtyRows, m_stats);
+        }
+    }
+}
+
+// Mirrors SampleItem::tick over the columns, returns true if the row completed
+bool SampleColumnStore::stepRow(int row, SampleDirtyTracker& dirtyRows, SampleStats& stats)
+{
+    int changes = SampleItem::StepChange;
+    const int step = m_steps[row];
+    m_steps[row] += m_stepRates[row];
+    const bool completed = m_steps[row] >= m_maxSteps[row];
+    if (completed)
+    {
+        m_steps[row] = m_maxSteps[row];
+        m_states[row] = SampleItem::COMPLETE;
+        changes |= SampleItem::StateChange;
+    }
+    stats.changeRow(SampleItem::STEPPING, step, m_maxSteps[row], state(row), m_steps[row], m_maxSteps[row]);
+    dirtyRows.mark(row, changes);
+    return completed;
+}
+
+void SampleColumnStore::restore(const std::shared_ptr<SampleSnapshot>& snapshot)
+{
+    const int rows = snapshot->count();
+    m_states.assign(snapshot->states(), snapshot->states() + rows);
+    m_steps.assign(snapshot->steps(), snapshot->steps() + rows);
+    m_maxSteps.assign(snapshot->maxSteps(), snapshot->maxSteps() + rows);
+    m_stepRates.assign(snapshot->stepRates(), snapshot->stepRates() + rows);
+
+    m_nameHandles.resize(rows);
+    m_ids.resize(rows);
+    m_activeRows.clear();
+    m_activeSlots.assign(rows, -1);
+    m_stats.clear();
+    for (int row = 0; row < rows; ++row)
+    {
+        m_nameHandles[row] = -row - 1;
+        m_ids[row] = static_cast<quint32>(row);
+        m_stats.addRow(state(row), m_steps[row], m_maxSteps[row]);
+        if (m_states[row] == SampleItem::STEPPING)
+        {
+            insertActive(row);
+        }
+    }
+    m_nextId = static_cast<quint32>(rows);
+
+    m_namePool.clear();
+    m_freeNames.clear();
+    m_snapshot = snapshot;
+}
+
+// Names still read from the snapshot move into the pool before it is closed
+void SampleColumnStore::releaseSnapshot(const QString& path)
+{
+    if (!m_snapshot || QFileInfo(m_snapshot->path()) != QFileInfo(path))
+    {
+        return;
+    }
+    for (size_t row = 0; row < m_nameHandles.size(); ++row)
+    {
+        const int handle = m_nameHandles[row];
+        if (handle < 0)
+        {
+            m_nameHandles[row] = acquireName(m_snapshot->name(-handle - 1));
+        }
+    }
+    m_snapshot.reset();
+}
+
+//===========================================================================================================
+// Active Set
+//===========================================================================================================
+
+int SampleColumnStore::activeCount() const
+{
+    return static_cast<int>(m_activeRows.size());
+}
+
+// Completed rows stay in the set until finishActive, so disjoint entries can be stepped concurrently
+void SampleColumnStore::tickActive(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    SampleStats delta;
+    for (int slot = first; slot <= last; ++slot)
+    {
+        const int row = m_activeRows[slot];
+        if (m_states[row] == SampleItem::STEPPING)
+        {
+            stepRow(row, dirtyRows, delta);
+        }
+    }
+    mergeStats(delta);
+}
+
+// Swapping from the back keeps the entries not yet visited ahead of the cursor
+void SampleColumnStore::finishActive()
+{
+    for (int slot = activeCount() - 1; slot >= 0; --slot)
+    {
+        const int row = m_activeRows[slot];
+        if (m_states[row] != SampleItem::STEPPING)
+        {
+            removeActive(row);
+        }
+    }
+}
+
+void SampleColumnStore::insertActive(int row)
+{
+    if (m_activeSlots[row] < 0)
+    {
+        m_activeSlots[row] = activeCount();
+        m_activeRows.push_back(row);
+    }
+}
+
+void SampleColumnStore::removeActive(int row)
+{
+    const int slot = m_activeSlots[row];
+    if (slot < 0)
+    {
+        return;
+    }
+
+    const int lastRow = m_activeRows.back();
+    m_activeRows[slot] = lastRow;
+    m_activeSlots[lastRow] = slot;
+    m_activeRows.pop_back();
+    m_activeSlots[row] = -1;
+}
+
+// Points the set at the new rows of the active rows between first and last after they shifted
+void SampleColumnStore::updateActiveRows(int first, int last)
+{
+    if (m_activeRows.empty())
+    {
+        return;
+    }
+
+    for (int row = first; row <= last; ++row)
+    {
+        if (m_activeSlots[row] >= 0)
+        {
+            m_activeRows[m_activeSlots[row]] = row;
+        }
+    }
+}
+
+// Rotates the elements into place so the column is only shifted once
+template <typename T>
+void SampleColumnStore::moveElements(std::vector<T>& column, int from, int count, int to)
+{
+    if (from < to)
+    {
+        std::rotate(column.begin() + from, column.begin() + from + count, column.begin() + to + count);
+    }
+    else if (from > to)
+    {
+        std::rotate(column.begin() + to, column.begin() + from, column.begin() + from + count);
+    }
+}
+
+int SampleColumnStore::acquireName(const QString& name)
+{
+    if (!m_freeNames.empty())
+    {
+        const int handle = m_freeNames.back();
+        m_freeNames.pop_back();
+        m_namePool[handle] = name;
+        return handle;
+    }
+    m_namePool.push_back(name);
+    return m_namePool.size() - 1;
+}
+
+void SampleColumnStore::releaseName(int handle)
+{
+    if (handle < 0)
+    {
+        return;
+    }
+
+    m_namePool[handle] = QString();
+    m_freeNames.push_back(handle);
+}
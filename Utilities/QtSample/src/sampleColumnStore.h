@@ -0,0 +1,78 @@
+#pragma once
+#include "sampleStore.h"
+#include <qvector.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/**
+* Stores each field of the rows in its own contiguous array
+* Names live in a pool and rows hold a handle so moving rows only shifts integers
+* Stepping rows are kept in an active set, each row holds its slot in a column
+*/
+class SampleColumnStore : public SampleStore
+{
+public:
+    SampleColumnStore();
+    virtual ~SampleColumnStore();
+
+    virtual int count() const override;
+    virtual QString name(int row) const override;
+    virtual SampleItem::State state(int row) const override;
+    virtual int step(int row) const override;
+    virtual int maxSteps(int row) const override;
+    virtual int stepRate(int row) const override;
+    virtual quint32 id(int row) const override;
+
+    virtual void setName(int row, const QString& name) override;
+    virtual void setState(int row, SampleItem::State state) override;
+    virtual void setStep(int row, int step) override;
+    virtual void setMaxSteps(int row, int maxSteps) override;
+    virtual void setStepRate(int row, int stepRate) override;
+
+    virtual void reserve(int count) override;
+    virtual void append(const QString& name) override;
+    virtual void remove(int row, int count) override;
+    virtual void move(int from, int count, int to) override;
+
+    virtual void tick(int first, int last, SampleDirtyTracker& dirtyRows) override;
+
+    virtual int activeCount() const override;
+    virtual void tickActive(int first, int last, SampleDirtyTracker& dirtyRows) override;
+    virtual void finishActive() override;
+
+    /**
+    * Copies the numeric columns and walks every row for the statistics and active set,
+    * names stay in the mapped snapshot and every read of one decodes a new string
+    */
+    virtual void restore(const std::shared_ptr<SampleSnapshot>& snapshot) override;
+    virtual void releaseSnapshot(const QString& path) override;
+
+private:
+    template <typename T> static void moveElements(std::vector<T>& column, int from, int count, int to);
+
+    int acquireName(const QString& name);
+    void releaseName(int handle);
+
+    bool stepRow(int row, SampleDirtyTracker& dirtyRows, SampleStats& stats);
+    void insertActive(int row);
+    void removeActive(int row);
+    void updateActiveRows(int first, int last);
+
+    std::vector<uint8_t> m_states;
+    std::vector<int> m_steps;
+    std::vector<int> m_maxSteps;
+    std::vector<int> m_stepRates;
+    std::vector<int> m_nameHandles;
+    std::vector<quint32> m_ids;
+    quint32 m_nextId = 0;
+
+    // Rows of the active set, each row holds its slot or -1
+    std::vector<int> m_activeRows;
+    std::vector<int> m_activeSlots;
+
+    // Negative handles refer to names of the restored snapshot
+    QVector<QString> m_namePool;
+    std::vector<int> m_freeNames;
+    std::shared_ptr<SampleSnapshot> m_snapshot;
+};
@@ -0,0 +1,87 @@
+#include "sampleDirtyTracker.h"
+#include <algorithm>
+
+void SampleDirtyTracker::mark(int row, int changes)
+{
+    if (!m_entries.empty() && m_entries.back().row == row)
+    {
+        m_entries.back().changes |= changes;
+    }
+    else
+    {
+        m_entries.push_back({ row, changes });
+    }
+}
+
+void SampleDirtyTracker::flush(const onRangeFn& rangeFn)
+{
+    if (m_entries.empty())
+    {
+        return;
+    }
+
+    // Rows are usually marked in order while ticking, only sort if required
+    const auto lessRow = [](const Entry& a, const Entry& b) { return a.row < b.row; };
+    if (!std::is_sorted(m_entries.begin(), m_entries.end(), lessRow))
+    {
+        std::stable_sort(m_entries.begin(), m_entries.end(), lessRow);
+    }
+
+    // Entries are swapped out so ranges may safely mark new rows while flushing
+    std::vector<Entry> entries;
+    entries.swap(m_spare);
+    entries.swap(m_entries);
+
+    // Merge duplicate rows so each row reports all of its changes
+    size_t merged = 0;
+    for (size_t i = 1; i < entries.size(); ++i)
+    {
+        if (entries[i].row == entries[merged].row)
+        {
+            entries[merged].changes |= entries[i].changes;
+        }
+        else
+        {
+            entries[++merged] = entries[i];
+        }
+    }
+    entries.resize(merged + 1);
+
+    // Emit one range per run of adjacent rows with identical changes
+    size_t first = 0;
+    for (size_t i = 1; i <= entries.size(); ++i)
+    {
+        if (i == entries.size() ||
+            entries[i].row != entries[i - 1].row + 1 ||
+            entries[i].changes != entries[first].changes)
+        {
+            rangeFn(entries[first].row, entries[i - 1].row, entries[first].changes);
+            first = i;
+        }
+    }
+
+    // Keep the allocation around for the next batch
+    entries.clear();
+    entries.swap(m_spare);
+}
+
+void SampleDirtyTracker::merge(SampleDirtyTracker& other)
+{
+    m_entries.insert(m_entries.end(), other.m_entries.begin(), other.m_entries.end());
+    other.m_entries.clear();
+}
+
+void SampleDirtyTracker::clear()
+{
+    m_entries.clear();
+}
+
+bool SampleDirtyTracker::isEmpty() const
+{
+    return m_entries.empty();
+}
+
+int SampleDirtyTracker::count() const
+{
+    return static_cast<int>(m_entries.size());
+}
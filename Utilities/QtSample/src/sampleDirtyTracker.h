@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <functional>
+
+/**
+* Collects rows changed during a batch and coalesces them into contiguous
+* ranges sharing the same change flags so each range can be notified once
+*/
+class SampleDirtyTracker
+{
+public:
+    typedef std::function<void(int first, int last, int changes)> onRangeFn;
+
+    void mark(int row, int changes);
+    void flush(const onRangeFn& rangeFn);
+
+    /**
+    * Moves the rows marked in other to the end of this tracker
+    */
+    void merge(SampleDirtyTracker& other);
+    void clear();
+    bool isEmpty() const;
+
+    /**
+    * Number of marks since the last flush, a row marked twice counts twice
+    */
+    int count() const;
+
+private:
+    struct Entry
+    {
+        int row;
+        int changes;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_spare;
+};
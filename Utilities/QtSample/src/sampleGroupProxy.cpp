@@ -0,0 +1,597 @@
+#include "sampleGroupProxy.h"
+#include "sampleModel.h"
+#include "sampleStats.h"
+#include <algorithm>
+
+// Group rows have an internal id of 0, the rows of group n have n + 1
+SampleGroupProxy::SampleGroupProxy(QObject* parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+SampleGroupProxy::~SampleGroupProxy() = default;
+
+//===========================================================================================================
+// Grouping
+//===========================================================================================================
+
+SampleGroupProxy::GroupBy SampleGroupProxy::groupBy() const
+{
+    return m_groupBy;
+}
+
+void SampleGroupProxy::setGroupBy(GroupBy groupBy)
+{
+    if (m_groupBy != groupBy)
+    {
+        beginResetModel();
+        m_groupBy = groupBy;
+        rebuild();
+        endResetModel();
+        emit groupingChanged();
+    }
+}
+
+int SampleGroupProxy::prefixLength() const
+{
+    return m_prefixLength;
+}
+
+void SampleGroupProxy::setPrefixLength(int length)
+{
+    length = std::max(length, 0);
+    if (m_prefixLength != length)
+    {
+        beginResetModel();
+        m_prefixLength = length;
+        rebuild();
+        endResetModel();
+        emit groupingChanged();
+    }
+}
+
+int SampleGroupProxy::groupCount() const
+{
+    return static_cast<int>(m_groups.size());
+}
+
+int SampleGroupProxy::groupRowCount(int group) const
+{
+    return group >= 0 && group < groupCount() ? m_groups[group].count : 0;
+}
+
+//===========================================================================================================
+// QAbstractProxyModel
+//===========================================================================================================
+
+void SampleGroupProxy::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+    for (const auto& connection : m_sourceConnections)
+    {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    // Rows of a SampleModel are read from its store, data() would fill its role cache with every row
+    const SampleModel* model = qobject_cast<const SampleModel*>(sourceModel);
+    m_store = model ? &model->store() : nullptr;
+
+    if (sourceModel)
+    {
+        // Moves and resets rebuild the groups, anything else updates them
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &SampleGroupProxy::onDataChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &SampleGroupProxy::onRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &SampleGroupProxy::onRowsAboutToBeRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &SampleGroupProxy::onRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this, &SampleGroupProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &SampleGroupProxy::onLayoutChanged),
+            connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &SampleGroupProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &SampleGroupProxy::onLayoutChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &SampleGroupProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &SampleGroupProxy::onLayoutChanged)
+        };
+    }
+
+    rebuild();
+    endResetModel();
+}
+
+QModelIndex SampleGroupProxy::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || proxyIndex.internalId() == 0 || !sourceModel())
+    {
+        return QModelIndex();
+    }
+    const Group& group = m_groups[proxyIndex.internalId() - 1];
+    return sourceModel()->index(group.rows[proxyIndex.row()], proxyIndex.column());
+}
+
+// Rows not fetched yet have no index in the proxy
+QModelIndex SampleGroupProxy::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    const int row = sourceIndex.row();
+    if (!sourceIndex.isValid() || row >= static_cast<int>(m_rowGroups.size()))
+    {
+        return QModelIndex();
+    }
+
+    const int group = m_rowGroups[row];
+    const auto begin = m_groups[group].rows.begin();
+    const auto end = begin + m_groups[group].fetched;
+    const auto found = std::lower_bound(begin, end, row);
+    if (found == end || *found != row)
+    {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(found - begin), sourceIndex.column(), static_cast<quintptr>(group + 1));
+}
+
+QModelIndex SampleGroupProxy::index(int row, int column, const QModelIndex& parent) const
+{
+    if (!hasIndex(row, column, parent))
+    {
+        return QModelIndex();
+    }
+    return parent.isValid() ? createIndex(row, column, static_cast<quintptr>(parent.row() + 1)) :
+        createIndex(row, column, static_cast<quintptr>(0));
+}
+
+QModelIndex SampleGroupProxy::parent(const QModelIndex& child) const
+{
+    if (!child.isValid() || child.internalId() == 0)
+    {
+        return QModelIndex();
+    }
+    return groupIndex(static_cast<int>(child.internalId()) - 1);
+}
+
+int SampleGroupProxy::rowCount(const QModelIndex& parent) const
+{
+    if (!parent.isValid())
+    {
+        return groupCount();
+    }
+    return parent.internalId() == 0 ? m_groups[parent.row()].fetched : 0;
+}
+
+int SampleGroupProxy::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+// Groups report their children before any are fetched so views offer to expand them
+bool SampleGroupProxy::hasChildren(const QModelIndex& parent) const
+{
+    if (!parent.isValid())
+    {
+        return !m_groups.empty();
+    }
+    return parent.internalId() == 0 && m_groups[parent.row()].count > 0;
+}
+
+bool SampleGroupProxy::canFetchMore(const QModelIndex& parent) const
+{
+    return parent.isValid() && parent.internalId() == 0 &&
+        m_groups[parent.row()].fetched < m_groups[parent.row()].count;
+}
+
+// The rows of a group are listed on its first fetch and handed out in blocks
+void SampleGroupProxy::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent))
+    {
+        return;
+    }
+
+    Group& group = m_groups[parent.row()];
+    if (!group.listed)
+    {
+        listRows(parent.row());
+    }
+    const int count = std::min(FetchRows, group.count - group.fetched);
+    beginInsertRows(parent, group.fetched, group.fetched + count - 1);
+    group.fetched += count;
+    endInsertRows();
+}
+
+QVariant SampleGroupProxy::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid())
+    {
+        return QVariant();
+    }
+
+    if (index.internalId() != 0)
+    {
+        if (role == IsGroupRole)
+        {
+            return false;
+        }
+        return role == GroupCountRole ? QVariant() : QAbstractProxyModel::data(index, role);
+    }
+
+    const Group& group = m_groups[index.row()];
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case SampleModel::NameRole:
+        return group.label;
+    case SampleModel::StateDescRole:
+        return group.state >= 0 ? QVariant(group.label) : QVariant();
+    case SampleModel::StateValueRole:
+        return group.state >= 0 ? QVariant(group.state) : QVariant();
+    case IsGroupRole:
+        return true;
+    case GroupCountRole:
+        return group.count;
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags SampleGroupProxy::flags(const QModelIndex& index) const
+{
+    if (index.isValid() && index.internalId() == 0)
+    {
+        return Qt::ItemIsEnabled;
+    }
+    return QAbstractProxyModel::flags(index);
+}
+
+QHash<int, QByteArray> SampleGroupProxy::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractProxyModel::roleNames();
+    roles[IsGroupRole] = "isGroup";
+    roles[GroupCountRole] = "groupCount";
+    return roles;
+}
+
+//===========================================================================================================
+// Source Changes
+//===========================================================================================================
+
+// Rows are only regrouped when the role they are grouped by changed
+void SampleGroupProxy::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (m_resetDepth > 0 || topLeft.parent().isValid())
+    {
+        return;
+    }
+
+    const int first = topLeft.row();
+    const int last = std::min(bottomRight.row(), static_cast<int>(m_rowGroups.size()) - 1);
+    const int groupRole = m_groupBy == GroupByState ? SampleModel::StateValueRole : SampleModel::NameRole;
+    std::vector<int> changedGroups;
+    if (roles.isEmpty() || roles.contains(groupRole))
+    {
+        for (int row = first; row <= last; ++row)
+        {
+            const int oldGroup = m_rowGroups[row];
+            const int group = groupOf(row, true);
+            if (group != oldGroup)
+            {
+                removeListedRow(oldGroup, row);
+                --m_groups[oldGroup].count;
+                ++m_groups[group].count;
+                m_rowGroups[row] = group;
+                insertListedRow(group, row);
+                changedGroups.push_back(oldGroup);
+                changedGroups.push_back(group);
+            }
+        }
+    }
+
+    // Only groups holding a row of the range are searched, the fetched rows of a group
+    // are in source order, so those in the range are contiguous
+    std::vector<bool> affected(groupCount(), false);
+    for (int row = first; row <= last; ++row)
+    {
+        affected[m_rowGroups[row]] = true;
+    }
+
+    for (int group = 0; group < groupCount(); ++group)
+    {
+        if (!affected[group])
+        {
+            continue;
+        }
+
+        const auto begin = m_groups[group].rows.begin();
+        const auto end = begin + m_groups[group].fetched;
+        const auto lower = std::lower_bound(begin, end, first);
+        const auto upper = std::upper_bound(lower, end, last);
+        if (lower != upper)
+        {
+            const quintptr id = static_cast<quintptr>(group + 1);
+            emit dataChanged(createIndex(static_cast<int>(lower - begin), 0, id),
+                createIndex(static_cast<int>(upper - begin) - 1, 0, id), roles);
+        }
+    }
+    emitGroupsChanged(changedGroups);
+}
+
+// Listed rows behind the inserted ones shift, their position within their group stays the same
+void SampleGroupProxy::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    const int count = last - first + 1;
+    for (auto& group : m_groups)
+    {
+        for (auto itr = std::lower_bound(group.rows.begin(), group.rows.end(), first); itr != group.rows.end(); ++itr)
+        {
+            *itr += count;
+        }
+    }
+    m_rowGroups.insert(m_rowGroups.begin() + first, count, 0);
+
+    std::vector<int> changedGroups;
+    for (int row = first; row <= last; ++row)
+    {
+        const int group = groupOf(row, true);
+        m_rowGroups[row] = group;
+        ++m_groups[group].count;
+        insertListedRow(group, row);
+        if (changedGroups.empty() || changedGroups.back() != group)
+        {
+            changedGroups.push_back(group);
+        }
+    }
+    emitGroupsChanged(changedGroups);
+}
+
+// The removed rows leave the groups while the source still has them, the rest shift once they are gone
+void SampleGroupProxy::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    for (int group = 0; group < groupCount(); ++group)
+    {
+        Group& entry = m_groups[group];
+        const auto lower = std::lower_bound(entry.rows.begin(), entry.rows.end(), first);
+        const auto upper = std::upper_bound(lower, entry.rows.end(), last);
+        const int lowerRow = static_cast<int>(lower - entry.rows.begin());
+        const int fetchedRows = std::min(static_cast<int>(upper - entry.rows.begin()), entry.fetched) - lowerRow;
+        if (fetchedRows > 0)
+        {
+            beginRemoveRows(groupIndex(group), lowerRow, lowerRow + fetchedRows - 1);
+            entry.rows.erase(lower, upper);
+            entry.fetched -= fetchedRows;
+            endRemoveRows();
+        }
+        else
+        {
+            entry.rows.erase(lower, upper);
+        }
+    }
+
+    for (int row = first; row <= last; ++row)
+    {
+        --m_groups[m_rowGroups[row]].count;
+    }
+}
+
+void SampleGroupProxy::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    const int count = last - first + 1;
+    for (auto& group : m_groups)
+    {
+        for (auto itr = std::lower_bound(group.rows.begin(), group.rows.end(), last + 1); itr != group.rows.end(); ++itr)
+        {
+            *itr -= count;
+        }
+    }
+    m_rowGroups.erase(m_rowGroups.begin() + first, m_rowGroups.begin() + last + 1);
+
+    // Counts may have changed in any group, there are few enough to notify them all
+    if (!m_groups.empty())
+    {
+        emit dataChanged(groupIndex(0), groupIndex(groupCount() - 1), { GroupCountRole });
+    }
+}
+
+void SampleGroupProxy::onLayoutAboutToChange()
+{
+    if (m_resetDepth++ == 0)
+    {
+        beginResetModel();
+    }
+}
+
+void SampleGroupProxy::onLayoutChanged()
+{
+    if (m_resetDepth > 0 && --m_resetDepth == 0)
+    {
+        rebuild();
+        endResetModel();
+    }
+}
+
+//===========================================================================================================
+// Groups
+//===========================================================================================================
+
+QModelIndex SampleGroupProxy::groupIndex(int group) const
+{
+    return createIndex(group, 0, static_cast<quintptr>(0));
+}
+
+// Rows with a prefix not seen before start a new group, which is appended
+int SampleGroupProxy::groupOf(int sourceRow, bool notify)
+{
+    if (m_groupBy == GroupByState)
+    {
+        const int state = m_store ? m_store->state(sourceRow) :
+            sourceModel()->data(sourceModel()->index(sourceRow, 0), SampleModel::StateValueRole).toInt();
+        return std::min(std::max(state, 0), SampleStats::StateCount - 1);
+    }
+
+    const QString name = m_store ? m_store->name(sourceRow) :
+        sourceModel()->data(sourceModel()->index(sourceRow, 0), SampleModel::NameRole).toString();
+    const QString label = prefixOf(name);
+    const auto found = m_groupLabels.constFind(label);
+    return found != m_groupLabels.constEnd() ? found.value() : addGroup(label, -1, notify);
+}
+
+int SampleGroupProxy::addGroup(const QString& label, int state, bool notify)
+{
+    const int group = groupCount();
+    if (notify)
+    {
+        beginInsertRows(QModelIndex(), group, group);
+    }
+    Group entry;
+    entry.label = label;
+    entry.state = state;
+    m_groups.push_back(std::move(entry));
+    m_groupLabels.insert(label, group);
+    if (notify)
+    {
+        endInsertRows();
+        emit groupCountChanged();
+    }
+    return group;
+}
+
+QString SampleGroupProxy::prefixOf(const QString& name) const
+{
+    if (m_prefixLength > 0)
+    {
+        return name.left(m_prefixLength);
+    }
+
+    int length = name.size();
+    while (length > 0 && name[length - 1].isDigit())
+    {
+        --length;
+    }
+    while (length > 0 && name[length - 1].isSpace())
+    {
+        --length;
+    }
+    return name.left(length);
+}
+
+void SampleGroupProxy::listRows(int group)
+{
+    Group& entry = m_groups[group];
+    entry.rows.clear();
+    entry.rows.reserve(entry.count);
+    const int rows = static_cast<int>(m_rowGroups.size());
+    for (int row = 0; row < rows; ++row)
+    {
+        if (m_rowGroups[row] == group)
+        {
+            entry.rows.push_back(row);
+        }
+    }
+    entry.listed = true;
+}
+
+// A row lands among the fetched rows unless it sorts after them while more are left to fetch
+void SampleGroupProxy::insertListedRow(int group, int sourceRow)
+{
+    Group& entry = m_groups[group];
+    if (!entry.listed)
+    {
+        return;
+    }
+
+    const auto position = std::lower_bound(entry.rows.begin(), entry.rows.end(), sourceRow);
+    const int row = static_cast<int>(position - entry.rows.begin());
+    if (row < entry.fetched || entry.fetched == static_cast<int>(entry.rows.size()))
+    {
+        beginInsertRows(groupIndex(group), row, row);
+        entry.rows.insert(position, sourceRow);
+        ++entry.fetched;
+        endInsertRows();
+    }
+    else
+    {
+        entry.rows.insert(position, sourceRow);
+    }
+}
+
+void SampleGroupProxy::removeListedRow(int group, int sourceRow)
+{
+    Group& entry = m_groups[group];
+    const auto position = std::lower_bound(entry.rows.begin(), entry.rows.end(), sourceRow);
+    if (position == entry.rows.end() || *position != sourceRow)
+    {
+        return;
+    }
+
+    const int row = static_cast<int>(position - entry.rows.begin());
+    if (row < entry.fetched)
+    {
+        beginRemoveRows(groupIndex(group), row, row);
+        entry.rows.erase(position);
+        --entry.fetched;
+        endRemoveRows();
+    }
+    else
+    {
+        entry.rows.erase(position);
+    }
+}
+
+// Emits one dataChanged of the count per contiguous range of groups
+void SampleGroupProxy::emitGroupsChanged(std::vector<int>& groups)
+{
+    if (groups.empty())
+    {
+        return;
+    }
+
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+    size_t first = 0;
+    for (size_t i = 1; i <= groups.size(); ++i)
+    {
+        if (i == groups.size() || groups[i] > groups[i - 1] + 1)
+        {
+            emit dataChanged(groupIndex(groups[first]), groupIndex(groups[i - 1]), { GroupCountRole });
+            first = i;
+        }
+    }
+    groups.clear();
+}
+
+// Assigns every row to its group, no group is listed until it is fetched again
+void SampleGroupProxy::rebuild()
+{
+    m_groups.clear();
+    m_groupLabels.clear();
+    if (m_groupBy == GroupByState)
+    {
+        for (int state = 0; state < SampleStats::StateCount; ++state)
+        {
+            addGroup(SampleItem::stateToString(static_cast<SampleItem::State>(state)), state, false);
+        }
+    }
+
+    const int rows = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_rowGroups.resize(rows);
+    for (int row = 0; row < rows; ++row)
+    {
+        const int group = groupOf(row, false);
+        m_rowGroups[row] = group;
+        ++m_groups[group].count;
+    }
+    emit groupCountChanged();
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <qabstractproxymodel.h>
+#include <qhash.h>
+#include <vector>
+
+class SampleStore;
+
+/**
+* Presents a SampleModel as a tree with one parent row per state or per name prefix
+* Only the group of every row and the row count of every group are kept for all rows,
+* the rows of a group are listed when it is first fetched, which views do on expanding
+* it, and handed to them in blocks as they scroll. Changes of the source move rows
+* between groups and update the counts in place, moves and resets of the source rebuild
+*/
+class SampleGroupProxy : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(GroupBy groupBy READ groupBy WRITE setGroupBy NOTIFY groupingChanged)
+    Q_PROPERTY(int prefixLength READ prefixLength WRITE setPrefixLength NOTIFY groupingChanged)
+    Q_PROPERTY(int groupCount READ groupCount NOTIFY groupCountChanged)
+
+public:
+    enum GroupBy
+    {
+        GroupByState,
+        GroupByNamePrefix
+    };
+    Q_ENUM(GroupBy)
+
+    /**
+    * Roles added to those of the source, group rows answer the name role with their label
+    */
+    enum GroupRoles
+    {
+        IsGroupRole = Qt::UserRole + 100,
+        GroupCountRole
+    };
+
+    static const int FetchRows = 1000;
+
+    SampleGroupProxy(QObject* parent = nullptr);
+    virtual ~SampleGroupProxy();
+
+    GroupBy groupBy() const;
+    void setGroupBy(GroupBy groupBy);
+
+    /**
+    * Name prefixes are the first prefixLength characters of a name, with 0 they are
+    * the name without its trailing number so items created together share a group
+    */
+    int prefixLength() const;
+    void setPrefixLength(int length);
+
+    int groupCount() const;
+    Q_INVOKABLE int groupRowCount(int group) const;
+
+    /**
+    * QAbstractProxyModel
+    */
+    virtual void setSourceModel(QAbstractItemModel* sourceModel) override;
+    virtual QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    virtual QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+    virtual QModelIndex index(int row, int column = 0, const QModelIndex& parent = QModelIndex()) const override;
+    virtual QModelIndex parent(const QModelIndex& child) const override;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    virtual bool canFetchMore(const QModelIndex& parent) const override;
+    virtual void fetchMore(const QModelIndex& parent) override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+    virtual QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void groupingChanged();
+    void groupCountChanged();
+
+private:
+    /**
+    * Rows holds the source rows of a listed group in ascending order,
+    * the first fetched of them are the children the views know about
+    */
+    struct Group
+    {
+        QString label;
+        int state = -1;
+        int count = 0;
+        bool listed = false;
+        int fetched = 0;
+        std::vector<int> rows;
+    };
+
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onLayoutAboutToChange();
+    void onLayoutChanged();
+
+    QModelIndex groupIndex(int group) const;
+    int groupOf(int sourceRow, bool notify);
+    int addGroup(const QString& label, int state, bool notify);
+    QString prefixOf(const QString& name) const;
+    void listRows(int group);
+    void insertListedRow(int group, int sourceRow);
+    void removeListedRow(int group, int sourceRow);
+    void emitGroupsChanged(std::vector<int>& groups);
+    void rebuild();
+
+    GroupBy m_groupBy = GroupByState;
+    int m_prefixLength = 0;
+    int m_resetDepth = 0;
+    const SampleStore* m_store = nullptr;
+    std::vector<Group> m_groups;
+    QHash<QString, int> m_groupLabels;
+    std::vector<int> m_rowGroups;
+    std::vector<QMetaObject::Connection> m_sourceConnections;
+};
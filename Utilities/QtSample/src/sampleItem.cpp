@@ -1,7 +1,9 @@
 #include "SampleItem.h"
+#include <qvector.h>
 #include <assert.h>
 
 const int MAX_STEPS = 100;
+const int SampleItem::DefaultMaxSteps = MAX_STEPS;
 
 SampleItem::~SampleItem() = default;
 SampleItem::SampleItem(const QString& name, onDataChangedFn changedFn, QObject* parent)
@@ -19,22 +21,40 @@ SampleItem::SampleItem(QObject* parent)
 {
 }
 
-void SampleItem::tick()
+// Returns the changes made instead of invoking the changed callback,
+// allowing the owner to batch notifications for many items
+int SampleItem::tick()
 {
+    int changes = NoChange;
     if (m_state == STEPPING)
     {
-        ++m_step;
-        if (m_step >= MAX_STEPS)
+        m_step += m_stepRate;
+        changes |= StepChange;
+        if (m_step >= m_maxSteps)
         {
-            m_step = MAX_STEPS;
+            m_step = m_maxSteps;
             m_state = COMPLETE;
+            changes |= StateChange;
         }
+    }
+    return changes;
+}
 
-        if (m_changedFn)
+// The strings are built once so every caller shares the same string data
+const QString& SampleItem::stateToString(State state)
+{
+    static const QVector<QString> names = []()
+    {
+        const QMetaEnum stateEnum = QMetaEnum::fromType<State>();
+        QVector<QString> result(STOPPED + 1);
+        for (int i = 0; i < stateEnum.keyCount(); ++i)
         {
-            m_changedFn(this);
+            result[stateEnum.value(i)] = QString::fromLatin1(stateEnum.key(i));
         }
-    }
+        return result;
+    }();
+    static const QString unknown;
+    return state >= 0 && state < names.size() ? names[state] : unknown;
 }
 
 const QString& SampleItem::getName() const
@@ -44,7 +64,7 @@ const QString& SampleItem::getName() const
 
 QString SampleItem::getStateAsString() const
 {
-    return m_stateEnum.valueToKey(m_state);
+    return stateToString(m_state);
 }
 
 SampleItem::State SampleItem::getState() const
@@ -57,9 +77,59 @@ int SampleItem::getStep() const
     return m_step;
 }
 
+void SampleItem::setStep(int step)
+{
+    m_step = step;
+}
+
 int SampleItem::getMaxSteps() const
 {
-    return MAX_STEPS;
+    return m_maxSteps;
+}
+
+void SampleItem::setMaxSteps(int maxSteps)
+{
+    m_maxSteps = maxSteps;
+}
+
+int SampleItem::getStepRate() const
+{
+    return m_stepRate;
+}
+
+void SampleItem::setStepRate(int stepRate)
+{
+    m_stepRate = stepRate;
+}
+
+void SampleItem::setRow(int row)
+{
+    m_row = row;
+}
+
+int SampleItem::getRow() const
+{
+    return m_row;
+}
+
+void SampleItem::setId(quint32 id)
+{
+    m_id = id;
+}
+
+quint32 SampleItem::getId() const
+{
+    return m_id;
+}
+
+void SampleItem::setActiveSlot(int slot)
+{
+    m_activeSlot = slot;
+}
+
+int SampleItem::getActiveSlot() const
+{
+    return m_activeSlot;
 }
 
 void SampleItem::start()
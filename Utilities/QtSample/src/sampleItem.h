@@ -25,24 +25,69 @@ public:
     };
     Q_ENUM(State)
 
-    void tick();
+    /**
+    * Flags describing what a call changed, used by the model to pick roles
+    */
+    enum Change
+    {
+        NoChange = 0x0,
+        StepChange = 0x1,
+        StateChange = 0x2,
+        NameChange = 0x4,
+        MaxStepChange = 0x8
+    };
+
+    static const int DefaultMaxSteps;
+    static const QString& stateToString(State state);
+
+    int tick();
     void start();
     void stop();
     void pause();
+    void setState(State state);
 
     void setName(const QString& name);
     const QString& getName() const;
     QString getStateAsString() const;
     State getState() const;
     int getStep() const;
+    void setStep(int step);
     int getMaxSteps() const;
+    void setMaxSteps(int maxSteps);
 
-private:
-    void setState(State state);
+    /**
+    * Steps advanced by each tick
+    */
+    int getStepRate() const;
+    void setStepRate(int stepRate);
+
+    /**
+    * Row of the item within its owning model, maintained by the model
+    */
+    void setRow(int row);
+    int getRow() const;
+
+    /**
+    * Identifier assigned by the owning store, stays with the item when rows move
+    */
+    void setId(quint32 id);
+    quint32 getId() const;
 
+    /**
+    * Position of the item in the active set of its store, -1 while not in it
+    */
+    void setActiveSlot(int slot);
+    int getActiveSlot() const;
+
+private:
     QMetaEnum m_stateEnum;
     QString m_name;
     State m_state;
     int m_step = 0;
+    int m_maxSteps = DefaultMaxSteps;
+    int m_stepRate = 1;
+    int m_row = -1;
+    int m_activeSlot = -1;
+    quint32 m_id = 0;
     onDataChangedFn m_changedFn = nullptr;
 };
\ No newline at end of file
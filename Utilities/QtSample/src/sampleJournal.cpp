@@ -0,0 +1,359 @@
+#include "sampleJournal.h"
+#include <algorithm>
+#include <cstring>
+
+// "SMJN" read as a little endian integer
+const quint32 SampleJournal::Magic = 0x4E4A4D53;
+// Version 2 adds the insertItems, restoreSnapshot and saveSnapshot operations
+const quint16 SampleJournal::Version = 2;
+
+namespace
+{
+    const int FlushBytes = 64 * 1024;
+    const qint64 FlushIntervalUs = 1000000;
+
+    void appendVarint(QByteArray& buffer, quint64 value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.append(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.append(static_cast<char>(value));
+    }
+
+    quint64 zigzag(qint64 value)
+    {
+        return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+    }
+
+    qint64 unzigzag(quint64 value)
+    {
+        return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+    }
+}
+
+//=====================================================================================================================
+// SampleJournal
+//=====================================================================================================================
+
+QList<int> SampleJournal::Entry::intList(size_t& index) const
+{
+    QList<int> values;
+    if (index < ints.size())
+    {
+        const size_t count = std::min(static_cast<size_t>(std::max(ints[index], 0)), ints.size() - index - 1);
+        values.reserve(static_cast<int>(count));
+        for (size_t i = 0; i < count; ++i)
+        {
+            values.append(ints[index + 1 + i]);
+        }
+        index += count + 1;
+    }
+    return values;
+}
+
+const char* SampleJournal::opName(Op op)
+{
+    static const char* names[OpCount] =
+    {
+        "tick",
+        "createItem",
+        "createItems",
+        "createItemCount",
+        "deleteItem",
+        "deleteItems",
+        "deleteItemRange",
+        "startItemProgress",
+        "stopItemProgress",
+        "pauseItemProgress",
+        "setItemMaxSteps",
+        "setItemStepRate",
+        "moveItems",
+        "moveItemRange",
+        "moveItemsTo",
+        "startItems",
+        "stopItems",
+        "pauseItems",
+        "startItemsInState",
+        "stopItemsInState",
+        "pauseItemsInState",
+        "setName",
+        "insertItems",
+        "restoreSnapshot",
+        "saveSnapshot"
+    };
+    return op < OpCount ? names[op] : "unknown";
+}
+
+//=====================================================================================================================
+// SampleJournalWriter
+//=====================================================================================================================
+
+SampleJournalWriter::Call::Call(SampleJournalWriter* writer, Op op)
+    : m_writer(writer)
+    , m_record(writer && writer->enter(op))
+{
+}
+
+SampleJournalWriter::Call::~Call()
+{
+    if (m_writer)
+    {
+        m_writer->leave();
+    }
+}
+
+SampleJournalWriter::Call& SampleJournalWriter::Call::operator<<(int value)
+{
+    if (m_record)
+    {
+        m_writer->m_entry.ints.push_back(value);
+    }
+    return *this;
+}
+
+SampleJournalWriter::Call& SampleJournalWriter::Call::operator<<(const QString& value)
+{
+    if (m_record)
+    {
+        m_writer->m_entry.strings.append(value);
+    }
+    return *this;
+}
+
+SampleJournalWriter::Call& SampleJournalWriter::Call::operator<<(const QStringList& values)
+{
+    if (m_record)
+    {
+        m_writer->m_entry.strings.append(values);
+    }
+    return *this;
+}
+
+SampleJournalWriter::Call& SampleJournalWriter::Call::operator<<(const QList<int>& values)
+{
+    if (m_record)
+    {
+        auto& ints = m_writer->m_entry.ints;
+        ints.push_back(values.size());
+        ints.insert(ints.end(), values.begin(), values.end());
+    }
+    return *this;
+}
+
+SampleJournalWriter::SampleJournalWriter()
+{
+    m_flushTimer.setInterval(static_cast<int>(FlushIntervalUs / 1000));
+    QObject::connect(&m_flushTimer, &QTimer::timeout, [this]()
+    {
+        if (m_file.isOpen() && !m_buffer.isEmpty())
+        {
+            flush();
+        }
+    });
+}
+
+SampleJournalWriter::~SampleJournalWriter()
+{
+    close();
+}
+
+bool SampleJournalWriter::open(const QString& path, int storageMode)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    const Header header = { Magic, Version, sizeof(Header), static_cast<quint32>(storageMode) };
+    m_buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_timer.start();
+    m_lastUs = 0;
+    m_lastFlushUs = 0;
+    m_entryCount = 0;
+    m_flushTimer.start();
+    return true;
+}
+
+void SampleJournalWriter::close()
+{
+    m_flushTimer.stop();
+    if (m_file.isOpen())
+    {
+        flush();
+        m_file.close();
+    }
+}
+
+bool SampleJournalWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+quint64 SampleJournalWriter::entryCount() const
+{
+    return m_entryCount;
+}
+
+// Starts the entry of the outermost call, its arguments follow through Call
+bool SampleJournalWriter::enter(Op op)
+{
+    if (m_depth++ > 0 || !m_file.isOpen())
+    {
+        return false;
+    }
+
+    const qint64 nowUs = m_timer.nsecsElapsed() / 1000;
+    m_entry.op = op;
+    m_entry.timeUs = nowUs - m_lastUs;
+    m_entry.ints.clear();
+    m_entry.strings.clear();
+    m_lastUs = nowUs;
+    return true;
+}
+
+// The entry is written once the outermost call returns
+void SampleJournalWriter::leave()
+{
+    if (--m_depth > 0 || !m_file.isOpen())
+    {
+        return;
+    }
+
+    m_buffer.append(static_cast<char>(m_entry.op));
+    appendVarint(m_buffer, static_cast<quint64>(m_entry.timeUs));
+    appendVarint(m_buffer, m_entry.ints.size());
+    for (const qint32 value : m_entry.ints)
+    {
+        appendVarint(m_buffer, zigzag(value));
+    }
+    appendVarint(m_buffer, static_cast<quint64>(m_entry.strings.size()));
+    for (const auto& string : m_entry.strings)
+    {
+        const QByteArray utf8 = string.toUtf8();
+        appendVarint(m_buffer, static_cast<quint64>(utf8.size()));
+        m_buffer.append(utf8);
+    }
+    ++m_entryCount;
+
+    // Flushing at least once a second keeps most of a session if the application crashes,
+    // calls made without returning to the event loop flush here instead of on the timer
+    if (m_buffer.size() >= FlushBytes || m_lastUs - m_lastFlushUs >= FlushIntervalUs)
+    {
+        flush();
+    }
+}
+
+void SampleJournalWriter::flush()
+{
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_buffer.clear();
+    m_lastFlushUs = m_lastUs;
+}
+
+//=====================================================================================================================
+// SampleJournalReader
+//=====================================================================================================================
+
+bool SampleJournalReader::open(const QString& path)
+{
+    m_data.clear();
+    m_offset = 0;
+    m_timeUs = 0;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    m_data = file.readAll();
+
+    Header header;
+    if (m_data.size() < static_cast<int>(sizeof(Header)))
+    {
+        return false;
+    }
+    memcpy(&header, m_data.constData(), sizeof(Header));
+    // Journals of earlier versions only lack operations, they replay as they are
+    if (header.magic != Magic || header.version < 1 || header.version > Version || header.headerSize < sizeof(Header) ||
+        header.headerSize > m_data.size())
+    {
+        m_data.clear();
+        return false;
+    }
+    m_storageMode = static_cast<int>(header.storageMode);
+    m_offset = header.headerSize;
+    return true;
+}
+
+int SampleJournalReader::storageMode() const
+{
+    return m_storageMode;
+}
+
+bool SampleJournalReader::next(Entry& entry)
+{
+    if (m_offset >= m_data.size())
+    {
+        return false;
+    }
+
+    entry.op = static_cast<Op>(static_cast<quint8>(m_data[m_offset++]));
+    quint64 timeUs = 0;
+    quint64 intCount = 0;
+    if (!readVarint(timeUs) || !readVarint(intCount) || intCount > static_cast<quint64>(m_data.size() - m_offset))
+    {
+        return false;
+    }
+
+    entry.ints.resize(static_cast<size_t>(intCount));
+    for (auto& value : entry.ints)
+    {
+        quint64 encoded = 0;
+        if (!readVarint(encoded))
+        {
+            return false;
+        }
+        value = static_cast<qint32>(unzigzag(encoded));
+    }
+
+    quint64 stringCount = 0;
+    if (!readVarint(stringCount) || stringCount > static_cast<quint64>(m_data.size() - m_offset))
+    {
+        return false;
+    }
+    entry.strings.clear();
+    for (quint64 i = 0; i < stringCount; ++i)
+    {
+        quint64 length = 0;
+        if (!readVarint(length) || length > static_cast<quint64>(m_data.size() - m_offset))
+        {
+            return false;
+        }
+        entry.strings.append(QString::fromUtf8(m_data.constData() + m_offset, static_cast<int>(length)));
+        m_offset += static_cast<int>(length);
+    }
+
+    m_timeUs += static_cast<qint64>(timeUs);
+    entry.timeUs = m_timeUs;
+    return true;
+}
+
+bool SampleJournalReader::readVarint(quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && m_offset < m_data.size(); shift += 7)
+    {
+        const quint8 byte = static_cast<quint8>(m_data[m_offset++]);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
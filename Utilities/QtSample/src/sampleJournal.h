@@ -0,0 +1,159 @@
+#pragma once
+#include <qbytearray.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qlist.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+#include <vector>
+
+/**
+* Binary journal of the calls made to a SampleModel, to replay a session headless
+* After the header every entry is the operation, the microseconds since the previous
+* entry and then its integer and string arguments, integers as zigzag varints and
+* strings as UTF-8 prefixed by their varint length. Integer list arguments are
+* stored as their count followed by the values
+* Rows inserted with their state are stored as the destination row followed by the
+* state, step, max steps and step rate of every row, their names are the strings
+*/
+class SampleJournal
+{
+public:
+    static const quint32 Magic;
+    static const quint16 Version;
+
+    enum Op : quint8
+    {
+        Tick,
+        CreateItem,
+        CreateItems,
+        CreateItemCount,
+        DeleteItem,
+        DeleteItems,
+        DeleteItemRange,
+        StartItemProgress,
+        StopItemProgress,
+        PauseItemProgress,
+        SetItemMaxSteps,
+        SetItemStepRate,
+        MoveItems,
+        MoveItemRange,
+        MoveItemsTo,
+        StartItems,
+        StopItems,
+        PauseItems,
+        StartItemsInState,
+        StopItemsInState,
+        PauseItemsInState,
+        SetName,
+        InsertItems,
+        RestoreSnapshot,
+        SaveSnapshot,
+        OpCount
+    };
+
+    struct Entry
+    {
+        Op op = Tick;
+        qint64 timeUs = 0;
+        std::vector<qint32> ints;
+        QStringList strings;
+
+        /**
+        * Reads the integer list starting at ints[index] and moves index past it
+        */
+        QList<int> intList(size_t& index) const;
+    };
+
+    static const char* opName(Op op);
+
+protected:
+    struct Header
+    {
+        quint32 magic;
+        quint16 version;
+        quint16 headerSize;
+        quint32 storageMode;
+    };
+};
+
+/**
+* Appends entries to a journal file, entries are buffered and written in blocks at least
+* once a second, by a timer of the thread that opened the journal while no calls are made
+* Calls made from within a recorded call are not recorded, replaying the outer call makes them again
+*/
+class SampleJournalWriter : public SampleJournal
+{
+public:
+    /**
+    * Records one call for as long as it is in scope, the arguments are only
+    * collected when the call is recorded
+    */
+    class Call
+    {
+    public:
+        Call(SampleJournalWriter* writer, Op op);
+        ~Call();
+
+        Call& operator<<(int value);
+        Call& operator<<(const QString& value);
+        Call& operator<<(const QStringList& values);
+        Call& operator<<(const QList<int>& values);
+
+    private:
+        Q_DISABLE_COPY(Call)
+
+        SampleJournalWriter* m_writer;
+        bool m_record;
+    };
+
+    SampleJournalWriter();
+    ~SampleJournalWriter();
+
+    bool open(const QString& path, int storageMode);
+    void close();
+    bool isOpen() const;
+    quint64 entryCount() const;
+
+private:
+    bool enter(Op op);
+    void leave();
+    void flush();
+
+    QFile m_file;
+    QTimer m_flushTimer;
+    QElapsedTimer m_timer;
+    qint64 m_lastUs = 0;
+    qint64 m_lastFlushUs = 0;
+    int m_depth = 0;
+    quint64 m_entryCount = 0;
+    Entry m_entry;
+    QByteArray m_buffer;
+};
+
+/**
+* Reads the entries of a journal file in order
+*/
+class SampleJournalReader : public SampleJournal
+{
+public:
+    /**
+    * Returns false if the file is missing or not a journal
+    */
+    bool open(const QString& path);
+    int storageMode() const;
+
+    /**
+    * Reads the next entry, its time is made relative to the start of the journal
+    * Returns false at the end or when the rest of the journal is truncated
+    */
+    bool next(Entry& entry);
+
+private:
+    bool readVarint(quint64& value);
+
+    QByteArray m_data;
+    int m_offset = 0;
+    int m_storageMode = 0;
+    qint64 m_timeUs = 0;
+};
@@ -0,0 +1,304 @@
+#include "sampleMetrics.h"
+#include <qalgorithms.h>
+#include <qfile.h>
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <algorithm>
+
+//===========================================================================================================
+// Histogram
+//===========================================================================================================
+
+void SampleHistogram::record(quint64 value)
+{
+    const int bucket = std::min(64 - static_cast<int>(qCountLeadingZeroBits(value)), BucketCount - 1);
+    ++m_buckets[bucket];
+    ++m_count;
+    m_sum += value;
+    m_max = std::max(m_max, value);
+}
+
+void SampleHistogram::clear()
+{
+    *this = SampleHistogram();
+}
+
+quint64 SampleHistogram::count() const
+{
+    return m_count;
+}
+
+quint64 SampleHistogram::sum() const
+{
+    return m_sum;
+}
+
+quint64 SampleHistogram::max() const
+{
+    return m_max;
+}
+
+double SampleHistogram::average() const
+{
+    return m_count ? static_cast<double>(m_sum) / m_count : 0.0;
+}
+
+// The top bucket is open ended, its values are bounded by the largest one seen instead
+quint64 SampleHistogram::percentile(double fraction) const
+{
+    const quint64 target = static_cast<quint64>(fraction * m_count);
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount - 1; ++bucket)
+    {
+        seen += m_buckets[bucket];
+        if (seen > target)
+        {
+            return std::min(quint64(1) << bucket, m_max);
+        }
+    }
+    return m_max;
+}
+
+QJsonObject SampleHistogram::toJson() const
+{
+    QJsonArray buckets;
+    int lastBucket = BucketCount - 1;
+    while (lastBucket > 0 && m_buckets[lastBucket] == 0)
+    {
+        --lastBucket;
+    }
+    for (int bucket = 0; bucket <= lastBucket; ++bucket)
+    {
+        buckets.append(static_cast<double>(m_buckets[bucket]));
+    }
+
+    QJsonObject result;
+    result["count"] = static_cast<double>(m_count);
+    result["sum"] = static_cast<double>(m_sum);
+    result["max"] = static_cast<double>(m_max);
+    result["average"] = average();
+    result["p50"] = static_cast<double>(percentile(0.5));
+    result["p95"] = static_cast<double>(percentile(0.95));
+    result["p99"] = static_cast<double>(percentile(0.99));
+    result["buckets"] = buckets;
+    return result;
+}
+
+//===========================================================================================================
+// Metrics
+//===========================================================================================================
+
+SampleMetrics::SampleMetrics(int firstRole, int roleCount, QObject* parent)
+    : QObject(parent)
+    , m_firstRole(firstRole)
+    , m_roleCalls(roleCount, 0)
+{
+    m_clock.start();
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(DefaultUpdateIntervalMs);
+    connect(&m_updateTimer, &QTimer::timeout, this, &SampleMetrics::updated);
+}
+
+SampleMetrics::~SampleMetrics() = default;
+
+bool SampleMetrics::isAvailable()
+{
+#ifdef SAMPLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SampleMetrics::isEnabled() const
+{
+    return m_enabled;
+}
+
+void SampleMetrics::setEnabled(bool enabled)
+{
+    enabled = enabled && isAvailable();
+    if (m_enabled != enabled)
+    {
+        m_enabled = enabled;
+        emit enabledChanged(enabled);
+    }
+}
+
+void SampleMetrics::setUpdateInterval(int intervalMs)
+{
+    m_updateTimer.setInterval(intervalMs);
+}
+
+qint64 SampleMetrics::now() const
+{
+    return m_enabled ? m_clock.nsecsElapsed() : 0;
+}
+
+void SampleMetrics::recordTick(qint64 startNs, int changedRows)
+{
+    if (m_enabled)
+    {
+        m_tickNs.record(static_cast<quint64>(m_clock.nsecsElapsed() - startNs));
+        m_tickRows.record(static_cast<quint64>(changedRows));
+        changed();
+    }
+}
+
+void SampleMetrics::recordDataChanged(int rows)
+{
+    if (m_enabled)
+    {
+        m_dataChangedRows.record(static_cast<quint64>(rows));
+        changed();
+    }
+}
+
+void SampleMetrics::recordInsert(int rows)
+{
+    if (m_enabled)
+    {
+        ++m_insertCount;
+        m_insertedRows += rows;
+        changed();
+    }
+}
+
+void SampleMetrics::recordRemove(int rows)
+{
+    if (m_enabled)
+    {
+        ++m_removeCount;
+        m_removedRows += rows;
+        changed();
+    }
+}
+
+void SampleMetrics::recordMove(int rows)
+{
+    if (m_enabled)
+    {
+        ++m_moveCount;
+        m_movedRows += rows;
+        changed();
+    }
+}
+
+quint64 SampleMetrics::ticks() const
+{
+    return m_tickNs.count();
+}
+
+double SampleMetrics::tickAverageUs() const
+{
+    return m_tickNs.average() / 1000.0;
+}
+
+double SampleMetrics::tickP95Us() const
+{
+    return m_tickNs.percentile(0.95) / 1000.0;
+}
+
+double SampleMetrics::tickMaxUs() const
+{
+    return m_tickNs.max() / 1000.0;
+}
+
+double SampleMetrics::steppedPerTick() const
+{
+    return m_tickRows.average();
+}
+
+quint64 SampleMetrics::dataChangedCount() const
+{
+    return m_dataChangedRows.count();
+}
+
+quint64 SampleMetrics::dataChangedRows() const
+{
+    return m_dataChangedRows.sum();
+}
+
+quint64 SampleMetrics::dataCalls() const
+{
+    quint64 calls = m_otherRoleCalls;
+    for (const quint64 roleCalls : m_roleCalls)
+    {
+        calls += roleCalls;
+    }
+    return calls;
+}
+
+quint64 SampleMetrics::dataCallsForRole(int role) const
+{
+    const size_t slot = static_cast<size_t>(role - m_firstRole);
+    return slot < m_roleCalls.size() ? m_roleCalls[slot] : 0;
+}
+
+quint64 SampleMetrics::insertedRows() const
+{
+    return m_insertedRows;
+}
+
+quint64 SampleMetrics::removedRows() const
+{
+    return m_removedRows;
+}
+
+quint64 SampleMetrics::movedRows() const
+{
+    return m_movedRows;
+}
+
+void SampleMetrics::reset()
+{
+    m_tickNs.clear();
+    m_tickRows.clear();
+    m_dataChangedRows.clear();
+    std::fill(m_roleCalls.begin(), m_roleCalls.end(), 0);
+    m_otherRoleCalls = 0;
+    m_insertCount = m_insertedRows = 0;
+    m_removeCount = m_removedRows = 0;
+    m_moveCount = m_movedRows = 0;
+    emit updated();
+}
+
+// Counts are written as doubles, which JSON and QML read exactly up to 2^53
+QJsonObject SampleMetrics::toJson() const
+{
+    QJsonObject dataCalls;
+    for (size_t slot = 0; slot < m_roleCalls.size(); ++slot)
+    {
+        dataCalls[QString::number(m_firstRole + static_cast<int>(slot))] = static_cast<double>(m_roleCalls[slot]);
+    }
+    dataCalls["other"] = static_cast<double>(m_otherRoleCalls);
+
+    const auto operation = [](quint64 count, quint64 rows)
+    {
+        QJsonObject result;
+        result["count"] = static_cast<double>(count);
+        result["rows"] = static_cast<double>(rows);
+        return result;
+    };
+
+    QJsonObject result;
+    result["enabled"] = m_enabled;
+    result["tickNs"] = m_tickNs.toJson();
+    result["tickChangedRows"] = m_tickRows.toJson();
+    result["dataChangedRows"] = m_dataChangedRows.toJson();
+    result["dataCalls"] = dataCalls;
+    result["insert"] = operation(m_insertCount, m_insertedRows);
+    result["remove"] = operation(m_removeCount, m_removedRows);
+    result["move"] = operation(m_moveCount, m_movedRows);
+    return result;
+}
+
+bool SampleMetrics::dumpJson(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(QJsonDocument(toJson()).toJson()) >= 0;
+}
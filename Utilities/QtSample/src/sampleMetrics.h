@@ -0,0 +1,164 @@
+#pragma once
+#include <qobject.h>
+#include <qelapsedtimer.h>
+#include <qjsonobject.h>
+#include <qtimer.h>
+#include <vector>
+
+/**
+* Recording sites are compiled in with SAMPLE_METRICS, see the SAMPLE_METRICS
+* CMake option, so a build without it pays nothing for them
+*/
+#ifdef SAMPLE_METRICS
+#define SAMPLE_METRIC(statement) statement
+#else
+#define SAMPLE_METRIC(statement)
+#endif
+
+/**
+* Counts values into power of two buckets, bucket n holds values below 2^n
+*/
+class SampleHistogram
+{
+public:
+    static const int BucketCount = 32;
+
+    void record(quint64 value);
+    void clear();
+
+    quint64 count() const;
+    quint64 sum() const;
+    quint64 max() const;
+    double average() const;
+
+    /**
+    * Upper bound of the bucket holding the given fraction of the recorded values
+    */
+    quint64 percentile(double fraction) const;
+    QJsonObject toJson() const;
+
+private:
+    quint64 m_buckets[BucketCount] = {};
+    quint64 m_count = 0;
+    quint64 m_sum = 0;
+    quint64 m_max = 0;
+};
+
+/**
+* Live counters and latency histograms of a SampleModel
+* Recording only touches plain counters, the properties are refreshed for bindings
+* at most once per update interval and only after something was recorded
+*/
+class SampleMetrics : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool available READ isAvailable CONSTANT)
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(quint64 ticks READ ticks NOTIFY updated)
+    Q_PROPERTY(double tickAverageUs READ tickAverageUs NOTIFY updated)
+    Q_PROPERTY(double tickP95Us READ tickP95Us NOTIFY updated)
+    Q_PROPERTY(double tickMaxUs READ tickMaxUs NOTIFY updated)
+    Q_PROPERTY(double steppedPerTick READ steppedPerTick NOTIFY updated)
+    Q_PROPERTY(quint64 dataChangedCount READ dataChangedCount NOTIFY updated)
+    Q_PROPERTY(quint64 dataChangedRows READ dataChangedRows NOTIFY updated)
+    Q_PROPERTY(quint64 dataCalls READ dataCalls NOTIFY updated)
+    Q_PROPERTY(quint64 insertedRows READ insertedRows NOTIFY updated)
+    Q_PROPERTY(quint64 removedRows READ removedRows NOTIFY updated)
+    Q_PROPERTY(quint64 movedRows READ movedRows NOTIFY updated)
+
+public:
+    static const int DefaultUpdateIntervalMs = 250;
+
+    SampleMetrics(int firstRole, int roleCount, QObject* parent = nullptr);
+    virtual ~SampleMetrics();
+
+    /**
+    * False when the recording sites were compiled out
+    */
+    static bool isAvailable();
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    void setUpdateInterval(int intervalMs);
+
+    /**
+    * Recording, each call is a no-op while disabled
+    */
+    qint64 now() const;
+    void recordTick(qint64 startNs, int changedRows);
+    void recordDataChanged(int rows);
+    void recordDataCall(int role) const;
+    void recordInsert(int rows);
+    void recordRemove(int rows);
+    void recordMove(int rows);
+
+    quint64 ticks() const;
+    double tickAverageUs() const;
+    double tickP95Us() const;
+    double tickMaxUs() const;
+    double steppedPerTick() const;
+    quint64 dataChangedCount() const;
+    quint64 dataChangedRows() const;
+    quint64 dataCalls() const;
+    Q_INVOKABLE quint64 dataCallsForRole(int role) const;
+    quint64 insertedRows() const;
+    quint64 removedRows() const;
+    quint64 movedRows() const;
+
+    Q_INVOKABLE void reset();
+    Q_INVOKABLE QJsonObject toJson() const;
+    Q_INVOKABLE bool dumpJson(const QString& path) const;
+
+signals:
+    void enabledChanged(bool enabled);
+    void updated();
+
+private:
+    void changed() const;
+
+    bool m_enabled = false;
+    int m_firstRole;
+    QElapsedTimer m_clock;
+    mutable QTimer m_updateTimer;
+
+    SampleHistogram m_tickNs;
+    SampleHistogram m_tickRows;
+    SampleHistogram m_dataChangedRows;
+    mutable std::vector<quint64> m_roleCalls;
+    mutable quint64 m_otherRoleCalls = 0;
+    quint64 m_insertCount = 0;
+    quint64 m_insertedRows = 0;
+    quint64 m_removeCount = 0;
+    quint64 m_removedRows = 0;
+    quint64 m_moveCount = 0;
+    quint64 m_movedRows = 0;
+};
+
+//===========================================================================================================
+// Recording, inline as it sits on the data() path
+//===========================================================================================================
+
+inline void SampleMetrics::changed() const
+{
+    if (!m_updateTimer.isActive())
+    {
+        m_updateTimer.start();
+    }
+}
+
+inline void SampleMetrics::recordDataCall(int role) const
+{
+    if (m_enabled)
+    {
+        const size_t slot = static_cast<size_t>(role - m_firstRole);
+        if (slot < m_roleCalls.size())
+        {
+            ++m_roleCalls[slot];
+        }
+        else
+        {
+            ++m_otherRoleCalls;
+        }
+        changed();
+    }
+}
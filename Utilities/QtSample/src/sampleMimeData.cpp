@@ -0,0 +1,166 @@
+#include "sampleMimeData.h"
+#include "sampleModel.h"
+#include "sampleStore.h"
+#include <qdatastream.h>
+#include <qmap.h>
+#include <qvariant.h>
+#include <utility>
+
+// "SMDI" read as a little endian integer
+const quint32 SampleMimeData::Magic = 0x49444D53;
+const quint16 SampleMimeData::Version = 2;
+
+SampleMimeData::SampleMimeData(SampleModel* model, std::vector<int> rows, std::vector<quint32> ids)
+    : m_model(model)
+    , m_rows(std::move(rows))
+    , m_ids(std::move(ids))
+{
+}
+
+SampleMimeData::~SampleMimeData() = default;
+
+SampleModel* SampleMimeData::model() const
+{
+    return m_model;
+}
+
+const std::vector<int>& SampleMimeData::rows() const
+{
+    return m_rows;
+}
+
+const std::vector<quint32>& SampleMimeData::ids() const
+{
+    return m_ids;
+}
+
+bool SampleMimeData::hasFormat(const QString& mimeType) const
+{
+    return mimeType == SampleModel::MimeKey || QMimeData::hasFormat(mimeType);
+}
+
+QStringList SampleMimeData::formats() const
+{
+    QStringList result = QMimeData::formats();
+    result.push_front(SampleModel::MimeKey);
+    return result;
+}
+
+// Encodes the payload on request, which only happens when the drop target
+// is not a SampleModel in this process
+QVariant SampleMimeData::retrieveData(const QString& mimeType, QVariant::Type type) const
+{
+    if (mimeType == SampleModel::MimeKey && m_model)
+    {
+        return m_model->encodeItems(*this);
+    }
+    return QMimeData::retrieveData(mimeType, type);
+}
+
+// Layout of version 2, little endian:
+// quint32 magic, quint16 version, quint32 count, then per row
+// quint8 state, qint32 step, qint32 max steps, qint32 step rate, quint32 name length, UTF-8 name
+// Version 1 rows have no step rate
+QByteArray SampleMimeData::encode(const SampleStore& store, const std::vector<int>& rows)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << Magic << Version << static_cast<quint32>(rows.size());
+    for (const int row : rows)
+    {
+        const QByteArray name = store.name(row).toUtf8();
+        stream << static_cast<quint8>(store.state(row))
+            << static_cast<qint32>(store.step(row))
+            << static_cast<qint32>(store.maxSteps(row))
+            << static_cast<qint32>(store.stepRate(row));
+        stream.writeBytes(name.constData(), static_cast<uint>(name.size()));
+    }
+    return result;
+}
+
+bool SampleMimeData::decode(const QByteArray& data, std::vector<Item>& items)
+{
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != Magic || version < 1 || version > Version)
+    {
+        return false;
+    }
+
+    // Every row takes at least 13 bytes, 17 with a step rate, reject counts the data cannot hold
+    const int headerSize = 10;
+    const bool hasStepRate = version >= 2;
+    if (count > static_cast<quint32>(data.size() - headerSize) / (hasStepRate ? 17 : 13))
+    {
+        return false;
+    }
+
+    items.clear();
+    items.reserve(count);
+    QByteArray name;
+    for (quint32 i = 0; i < count; ++i)
+    {
+        quint8 state = 0;
+        qint32 step = 0;
+        qint32 maxSteps = 0;
+        qint32 stepRate = 1;
+        quint32 nameSize = 0;
+        stream >> state >> step >> maxSteps;
+        if (hasStepRate)
+        {
+            stream >> stepRate;
+        }
+        stream >> nameSize;
+        if (stream.status() != QDataStream::Ok || state > SampleItem::STOPPED ||
+            nameSize > static_cast<quint32>(data.size()))
+        {
+            return false;
+        }
+
+        name.resize(static_cast<int>(nameSize));
+        if (stream.readRawData(name.data(), name.size()) != name.size())
+        {
+            return false;
+        }
+        items.push_back({ QString::fromUtf8(name), static_cast<SampleItem::State>(state), step, maxSteps, stepRate });
+    }
+    return true;
+}
+
+// Layout of QAbstractItemModel::mimeData, big endian:
+// per cell qint32 row, qint32 column, QMap<int, QVariant> of its roles
+bool SampleMimeData::decodeItemModelData(const QByteArray& data, std::vector<Item>& items)
+{
+    QDataStream stream(data);
+    items.clear();
+    while (!stream.atEnd())
+    {
+        int row = 0;
+        int column = 0;
+        QMap<int, QVariant> roles;
+        stream >> row >> column >> roles;
+        if (stream.status() != QDataStream::Ok)
+        {
+            return false;
+        }
+        if (column != 0)
+        {
+            continue;
+        }
+
+        const QVariant name = roles.contains(SampleModel::NameRole) ? roles.value(SampleModel::NameRole) :
+            roles.value(Qt::DisplayRole);
+        const int state = roles.value(SampleModel::StateValueRole, SampleItem::NONE).toInt();
+        const int maxSteps = roles.value(SampleModel::MaxStepRole, SampleItem::DefaultMaxSteps).toInt();
+        items.push_back({ name.toString(),
+            static_cast<SampleItem::State>(state >= SampleItem::NONE && state <= SampleItem::STOPPED ? state : SampleItem::NONE),
+            roles.value(SampleModel::StepRole, 0).toInt(), maxSteps, 1 });
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "sampleItem.h"
+#include <qmimedata.h>
+#include <qbytearray.h>
+#include <qpointer.h>
+#include <qstringlist.h>
+#include <vector>
+
+class SampleModel;
+class SampleStore;
+
+/**
+* Drag payload for the rows of a SampleModel
+* Drops within the process read the rows and their ids straight from the payload,
+* the binary encoding is only built when the data is requested by format
+*/
+class SampleMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    /**
+    * Header of the binary encoding, the version is bumped whenever the layout changes
+    */
+    static const quint32 Magic;
+    static const quint16 Version;
+
+    /**
+    * A row decoded from the binary encoding
+    */
+    struct Item
+    {
+        QString name;
+        SampleItem::State state;
+        int step;
+        int maxSteps;
+        int stepRate;
+    };
+
+    SampleMimeData(SampleModel* model, std::vector<int> rows, std::vector<quint32> ids);
+    virtual ~SampleMimeData();
+
+    SampleModel* model() const;
+    const std::vector<int>& rows() const;
+    const std::vector<quint32>& ids() const;
+
+    virtual bool hasFormat(const QString& mimeType) const override;
+    virtual QStringList formats() const override;
+
+    static QByteArray encode(const SampleStore& store, const std::vector<int>& rows);
+    static bool decode(const QByteArray& data, std::vector<Item>& items);
+
+    /**
+    * Decodes the default encoding of QAbstractItemModel::mimeData, rows
+    * are read from the name, state and step roles of their first column
+    * and step at the default rate
+    */
+    static bool decodeItemModelData(const QByteArray& data, std::vector<Item>& items);
+
+protected:
+    virtual QVariant retrieveData(const QString& mimeType, QVariant::Type type) const override;
+
+private:
+    QPointer<SampleModel> m_model;
+    std::vector<int> m_rows;
+    std::vector<quint32> m_ids;
+};
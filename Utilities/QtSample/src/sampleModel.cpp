@@ -1,21 +1,85 @@
 #include "SampleModel.h"
 #include "SampleItem.h"
+#include "sampleObjectStore.h"
+#include "sampleColumnStore.h"
+#include "samplePagedStore.h"
+#include "sampleSnapshot.h"
+#include "sampleSimulation.h"
+#include "sampleTickPool.h"
+#include "sampleSortProxy.h"
+#include "sampleGroupProxy.h"
+#include "sampleSearchProxy.h"
+#include "sampleTrace.h"
+#include <qdir.h>
+#include <qfile.h>
+#include <qmap.h>
 #include <qqml.h>
 #include <qqmlengine.h>
 #include <qvariant.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 SampleModel::~SampleModel() = default;
 SampleModel::SampleModel(QObject* parent)
+    : SampleModel(ObjectStorage, parent)
+{
+}
+
+SampleModel::SampleModel(StorageMode storageMode, QObject* parent)
     : QAbstractItemModel(parent)
+    , m_storageMode(storageMode)
+    , m_roleCache(NameRole, MaxStepRole - NameRole + 1)
+    , m_metrics(NameRole, MaxStepRole - NameRole + 1)
+    , m_objectPool(this)
 {
+    if (storageMode == ColumnStorage)
+    {
+        m_store.reset(new SampleColumnStore());
+    }
+    else if (storageMode == PagedStorage)
+    {
+        m_pagedStore = new SamplePagedStore();
+        m_store.reset(m_pagedStore);
+    }
+    else
+    {
+        m_store.reset(new SampleObjectStore());
+    }
+    connectStore();
+    m_summary.reset(new SampleSummary(m_store->stats()));
+
     fillTestItems();
 }
 
+void SampleModel::connectStore()
+{
+    m_store->setRowChangedFn([this](int row, int changes) { markRowChanged(row, changes); });
+}
+
 void SampleModel::qmlRegisterTypes()
 {
     // Register to allow SampleItemState enum in QML
     qmlRegisterType<SampleItem>("SampleModel", 1, 0, "SampleItemState");
 
+    // Register to allow SampleSortProxy { sourceModel: context_model } in QML
+    qmlRegisterType<SampleSortProxy>("SampleModel", 1, 0, "SampleSortProxy");
+
+    // Register to allow SampleGroupProxy { sourceModel: context_model; groupBy: SampleGroupProxy.GroupByState } in QML
+    qmlRegisterType<SampleGroupProxy>("SampleModel", 1, 0, "SampleGroupProxy");
+
+    // Register to allow SampleSearchProxy { sourceModel: context_model; query: searchField.text } in QML
+    qmlRegisterType<SampleSearchProxy>("SampleModel", 1, 0, "SampleSearchProxy");
+
+    // Register to allow binding to context_model.metrics in QML
+    qmlRegisterUncreatableType<SampleMetrics>("SampleModel", 1, 0, "SampleMetrics", "Metrics belong to a SampleModel");
+    qmlRegisterUncreatableType<SampleSummary>("SampleModel", 1, 0, "SampleSummary", "Summaries belong to a SampleModel");
+
+    // Register to allow reading the test lists through their typed wrappers in QML
+    qmlRegisterUncreatableType<SampleValueList>("SampleModel", 1, 0, "SampleValueList", "Lists belong to a SampleModel");
+    qmlRegisterUncreatableType<SampleIntList>("SampleModel", 1, 0, "SampleIntList", "Lists belong to a SampleModel");
+    qmlRegisterUncreatableType<SampleColorList>("SampleModel", 1, 0, "SampleColorList", "Lists belong to a SampleModel");
+
     // Register to allow TestObject {} in QML
     qmlRegisterType<Test::Object>("SampleModel", 1, 0, "TestObject");
 
@@ -46,14 +110,88 @@ QList<QObject*> SampleModel::returnObjectList()
     return list;
 }
 
-void SampleModel::fillTestItems()
+Test::Gadget SampleModel::returnGadget(int id) const
+{
+    return Test::Gadget(id);
+}
+
+QObject* SampleModel::acquireObject(int id)
+{
+    return m_objectPool.acquire(id);
+}
+
+QList<QObject*> SampleModel::acquireObjectList(int count, int firstId)
 {
-    for (int i = 0; i < 3; ++i)
+    QList<QObject*> list;
+    list.reserve(count);
+    for (int i = 0; i < count; ++i)
     {
-        m_intListTest.append(i);
-        m_colorListTest.append(QColor(i, i, i));
-        m_objectListTest.append(new Test::Object(i));
+        list.append(m_objectPool.acquire(firstId + i));
     }
+    return list;
+}
+
+void SampleModel::releaseObject(QObject* object)
+{
+    m_objectPool.release(object);
+}
+
+void SampleModel::releaseObjectList(const QList<QObject*>& objects)
+{
+    for (QObject* object : objects)
+    {
+        m_objectPool.release(object);
+    }
+}
+
+const SampleObjectPool& SampleModel::objectPool() const
+{
+    return m_objectPool;
+}
+
+// Appends count entries to each test list, the objects are owned by the model
+void SampleModel::fillTestItems(int count)
+{
+    std::vector<int> ints = m_intListTest.values();
+    std::vector<QColor> colors = m_colorListTest.values();
+    const int first = static_cast<int>(ints.size());
+    ints.reserve(first + count);
+    colors.reserve(first + count);
+    m_objectListTest.reserve(m_objectListTest.size() + count);
+    for (int i = first; i < first + count; ++i)
+    {
+        ints.push_back(i);
+        colors.push_back(QColor(i & 0xFF, i & 0xFF, i & 0xFF));
+        m_objectListTest.append(new Test::Object(i, this));
+    }
+    m_intListTest.assign(std::move(ints));
+    m_colorListTest.assign(std::move(colors));
+}
+
+SampleIntList* SampleModel::intListTest()
+{
+    return &m_intListTest;
+}
+
+SampleColorList* SampleModel::colorListTest()
+{
+    return &m_colorListTest;
+}
+
+QQmlListProperty<Test::Object> SampleModel::objectListTest()
+{
+    return QQmlListProperty<Test::Object>(this, &m_objectListTest, &SampleModel::objectListCount, &SampleModel::objectListAt);
+}
+
+int SampleModel::objectListCount(QQmlListProperty<Test::Object>* list)
+{
+    return static_cast<const QVector<Test::Object*>*>(list->data)->size();
+}
+
+Test::Object* SampleModel::objectListAt(QQmlListProperty<Test::Object>* list, int index)
+{
+    const auto* objects = static_cast<const QVector<Test::Object*>*>(list->data);
+    return index >= 0 && index < objects->size() ? objects->at(index) : nullptr;
 }
 
 //===========================================================================================================
@@ -63,7 +201,7 @@ void SampleModel::fillTestItems()
 int SampleModel::rowCount(const QModelIndex& parent) const
 {
     Q_UNUSED(parent);
-    return static_cast<int>(m_items.size());
+    return m_pagedStore ? m_fetchedRows : m_store->count();
 }
 
 int SampleModel::columnCount(const QModelIndex& parent) const
@@ -81,39 +219,111 @@ QModelIndex SampleModel::parent(const QModelIndex& child) const
     return QModelIndex();
 }
 
+// Values are cached until the dirty tracker reports their row and role as changed
 QVariant SampleModel::data(const QModelIndex& index, int role) const
 {
-    if (index.row() >= 0 && index.row() < static_cast<int>(m_items.size()))
+    const int row = index.row();
+    if (!isValidRow(row))
     {
-        const auto& item = m_items[index.row()];
-        if (role == NameRole)
-        {
-            return item->getName();
-        }
-        else if (role == StateDescRole)
+        return QVariant();
+    }
+    SAMPLE_METRIC(m_metrics.recordDataCall(role));
+
+    if (m_roleCacheEnabled)
+    {
+        if (const QVariant* cached = m_roleCache.find(row, role))
         {
-            return item->getStateAsString();
+            return *cached;
         }
-        else if (role == StateValueRole)
+    }
+
+    QVariant value = roleValue(row, role);
+    if (m_roleCacheEnabled && value.isValid())
+    {
+        m_roleCache.insert(row, role, value);
+    }
+    return value;
+}
+
+QVariant SampleModel::roleValue(int row, int role) const
+{
+    if (role == NameRole)
+    {
+        return m_store->name(row);
+    }
+    else if (role == StateDescRole)
+    {
+        return SampleItem::stateToString(m_store->state(row));
+    }
+    else if (role == StateValueRole)
+    {
+        return m_store->state(row);
+    }
+    else if (role == StepRole)
+    {
+        return m_store->step(row);
+    }
+    else if (role == MaxStepRole)
+    {
+        return m_store->maxSteps(row);
+    }
+    return QVariant();
+}
+
+// Fills several roles of a row in one call, checking the row only once
+void SampleModel::multiData(const QModelIndex& index, std::vector<RoleData>& roleData) const
+{
+    const int row = index.row();
+    const bool validRow = isValidRow(row);
+    for (auto& entry : roleData)
+    {
+        if (!validRow)
         {
-            return item->getState();
+            entry.data = QVariant();
+            continue;
         }
-        else if (role == StepRole)
+        SAMPLE_METRIC(m_metrics.recordDataCall(entry.role));
+
+        const QVariant* cached = m_roleCacheEnabled ? m_roleCache.find(row, entry.role) : nullptr;
+        if (cached)
         {
-            return item->getStep();
+            entry.data = *cached;
+            continue;
         }
-        else if (role == MaxStepRole)
+
+        entry.data = roleValue(row, entry.role);
+        if (m_roleCacheEnabled && entry.data.isValid())
         {
-            return item->getMaxSteps();
+            m_roleCache.insert(row, entry.role, entry.data);
         }
     }
-    return QVariant();
 }
 
 //===========================================================================================================
 // Optional QAbstractItemModel 
 //===========================================================================================================
 
+// Default calls data() for every Qt role followed by roleNames()
+QMap<int, QVariant> SampleModel::itemData(const QModelIndex& index) const
+{
+    std::vector<RoleData> roleData;
+    for (int role = NameRole; role <= MaxStepRole; ++role)
+    {
+        roleData.push_back({ role, QVariant() });
+    }
+    multiData(index, roleData);
+
+    QMap<int, QVariant> result;
+    for (const auto& entry : roleData)
+    {
+        if (entry.data.isValid())
+        {
+            result.insert(entry.role, entry.data);
+        }
+    }
+    return result;
+}
+
 QHash<int, QByteArray> SampleModel::roleNames() const
 {
     QHash<int, QByteArray> roles;
@@ -127,169 +337,1132 @@ QHash<int, QByteArray> SampleModel::roleNames() const
 
 bool SampleModel::setData(const QModelIndex &index, const QVariant &value, int role)
 {
-    if (index.row() >= 0 && index.row() < static_cast<int>(m_items.size()))
+    if (isValidRow(index.row()))
     {
-        const auto& item = m_items[index.row()];
         if (role == NameRole)
         {
-            item->setName(value.toString());
-            emit dataChanged(index, index);
+            SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::SetName);
+            journal << index.row() << value.toString();
+            m_store->setName(index.row(), value.toString());
             return true;
         }
     }
     return false;
 }
 
+// Moves rows with beginMoveRows so views keep their delegates
+bool SampleModel::moveRows(const QModelIndex& sourceParent, int sourceRow, int count,
+    const QModelIndex& destinationParent, int destinationChild)
+{
+    if (sourceParent.isValid() || destinationParent.isValid() || count <= 0 ||
+        sourceRow < 0 || sourceRow + count > rowCount() ||
+        destinationChild < 0 || destinationChild > rowCount())
+    {
+        return false;
+    }
+
+    SAMPLE_TRACE_SCOPE("model", "moveRows");
+    if (!beginMoveRows(QModelIndex(), sourceRow, sourceRow + count - 1, QModelIndex(), destinationChild))
+    {
+        return false;
+    }
+
+    const int to = destinationChild > sourceRow ? destinationChild - count : destinationChild;
+    m_store->move(sourceRow, count, to);
+    m_roleCache.clear();
+    endMoveRows();
+    SAMPLE_METRIC(m_metrics.recordMove(count));
+
+    if (m_simulation)
+    {
+        m_simulation->moveRows(sourceRow, count, to);
+    }
+    return true;
+}
+
+// Paged rows are handed to the views in blocks as they scroll towards the end
+bool SampleModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_pagedStore && m_fetchedRows < m_store->count();
+}
+
+void SampleModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent))
+    {
+        return;
+    }
+
+    SAMPLE_TRACE_SCOPE("model", "fetchMore");
+    const int count = std::min(FetchRows, m_store->count() - m_fetchedRows);
+    beginInsertRows(QModelIndex(), m_fetchedRows, m_fetchedRows + count - 1);
+    m_fetchedRows += count;
+    endInsertRows();
+}
+
 //===========================================================================================================
 // Drag and Drop
 //===========================================================================================================
 
-// Default checks if data has at least one format in the list of mimeTypes() 
-// and if action is in supportedDropActions(), only re-implement if needing custom checking
+// Accepts rows of this format or of the default item model format dropped between rows, either copied or moved
 bool SampleModel::canDropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) const
 {
-    return QAbstractItemModel::canDropMimeData(data, action, row, column, parent);
+    Q_UNUSED(row);
+    return data && (data->hasFormat(MimeKey) || data->hasFormat(ItemModelMimeKey)) && !parent.isValid() && column <= 0 &&
+        (action == Qt::CopyAction || action == Qt::MoveAction);
 }
 
 // Default returns Qt::CopyAction, Drop Action Flags
 Qt::DropActions SampleModel::supportedDropActions() const
 {
-    return QAbstractItemModel::supportedDropActions();
+    return Qt::CopyAction | Qt::MoveAction;
 }
 
 // Default returns supportedDropActions()
 Qt::DropActions SampleModel::supportedDragActions() const
 {
-    return QAbstractItemModel::supportedDragActions();
+    return Qt::CopyAction | Qt::MoveAction;
 }
 
-// Serializes the items at indexes to MimeData
-// Default uses mime type "application/x-qabstractitemmodeldatalist"
+// Rows can be dragged, drops are only accepted between rows
+Qt::ItemFlags SampleModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid())
+    {
+        return Qt::ItemIsDropEnabled;
+    }
+    return QAbstractItemModel::flags(index) | Qt::ItemIsDragEnabled;
+}
+
+// Captures the rows at indexes and their ids, nothing is serialized until a format is requested
+// Default uses mime type "application/x-qabstractitemmodeldatalist" and copies every role
 QMimeData* SampleModel::mimeData(const QModelIndexList& indexes) const
 {
-    return QAbstractItemModel::mimeData(indexes);
+    std::vector<int> rows;
+    rows.reserve(indexes.size());
+    for (const auto& index : indexes)
+    {
+        if (index.isValid() && index.column() == 0 && isValidRow(index.row()))
+        {
+            rows.push_back(index.row());
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    std::vector<quint32> ids;
+    ids.reserve(rows.size());
+    for (const int row : rows)
+    {
+        ids.push_back(m_store->id(row));
+    }
+
+    // The payload only reads from the model, but QPointer needs a mutable object
+    return new SampleMimeData(const_cast<SampleModel*>(this), std::move(rows), std::move(ids));
 }
 
-// Returns the supported Mime types
-// Default returns mime type "application/x-qabstractitemmodeldatalist"
+// Returns the supported Mime types, the own format first so drags of this model use it
+// Default returns mime type "application/x-qabstractitemmodeldatalist", kept for drops from other models
 QStringList SampleModel::mimeTypes() const
 {
-    QStringList result = QAbstractItemModel::mimeTypes();
-    result.push_back(MimeKey);
+    QStringList result(MimeKey);
+    result.append(QAbstractItemModel::mimeTypes());
     return result;
 }
 
-// Default tries to insert the items of data either as siblings or children of an item
+// Drops from this model move or copy the rows directly, other sources are decoded
 // Returns true if the data and action were handled by the model; otherwise returns false
 bool SampleModel::dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent)
 {
-    return QAbstractItemModel::dropMimeData(data, action, row, column, parent);
+    if (action == Qt::IgnoreAction)
+    {
+        return true;
+    }
+    if (!canDropMimeData(data, action, row, column, parent))
+    {
+        return false;
+    }
+
+    const int destination = row < 0 || row > rowCount() ? rowCount() : row;
+    const auto* sampleData = qobject_cast<const SampleMimeData*>(data);
+    if (sampleData && sampleData->model() == this && action == Qt::MoveAction)
+    {
+        QList<int> rows;
+        for (const int sourceRow : resolveRows(*sampleData))
+        {
+            rows.push_back(sourceRow);
+        }
+        moveItemsTo(rows, destination);
+        return true;
+    }
 
-    // Using Default Encoding of MimeData
-    QByteArray encoded = data->data("application/x-qabstractitemmodeldatalist");
-    QDataStream stream(&encoded, QIODevice::ReadOnly);
-    while (!stream.atEnd())
+    // Rows of a model in this process are read directly, anything else goes through the encoding
+    std::vector<SampleMimeData::Item> items;
+    if (sampleData && sampleData->model())
     {
-        int row, col;
-        QMap<int, QVariant> roleDataMap;
-        stream >> row >> col >> roleDataMap;
+        const SampleModel& source = *sampleData->model();
+        const std::vector<int> rows = source.resolveRows(*sampleData);
+        items.reserve(rows.size());
+        for (const int sourceRow : rows)
+        {
+            items.push_back({ source.m_store->name(sourceRow), source.m_store->state(sourceRow),
+                source.m_store->step(sourceRow), source.m_store->maxSteps(sourceRow), source.m_store->stepRate(sourceRow) });
+        }
+    }
+    else if (data->hasFormat(MimeKey))
+    {
+        if (!SampleMimeData::decode(data->data(MimeKey), items))
+        {
+            return false;
+        }
+    }
+    else if (!SampleMimeData::decodeItemModelData(data->data(ItemModelMimeKey), items))
+    {
+        return false;
     }
-    // Using Custom Encoding of MimeData
+
+    insertDroppedItems(items, destination);
+    return true;
+}
+
+QByteArray SampleModel::encodeItems(const SampleMimeData& data) const
+{
+    return SampleMimeData::encode(*m_store, resolveRows(data));
 }
 
 //===========================================================================================================
 // Custom Methods
 //===========================================================================================================
 
+// Moves a row so it ends up at newIndex
 void SampleModel::moveItems(int oldIndex, int newIndex)
 {
-    if (oldIndex >= 0 && newIndex >= 0 && oldIndex != newIndex)
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::MoveItems);
+    journal << oldIndex << newIndex;
+    if (isValidRow(oldIndex) && isValidRow(newIndex) && oldIndex != newIndex)
     {
-        beginRemoveRows({}, oldIndex, oldIndex);
-        const auto item = m_items.takeAt(oldIndex);
-        endRemoveRows();
+        moveRows(QModelIndex(), oldIndex, 1, QModelIndex(), newIndex > oldIndex ? newIndex + 1 : newIndex);
+    }
+}
 
-        beginInsertRows({}, newIndex, newIndex);
-        m_items.insert(newIndex, item);
-        endInsertRows();
+// Moves a block of rows in front of the row at destination
+void SampleModel::moveItemRange(int first, int count, int destination)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::MoveItemRange);
+    journal << first << count << destination;
+    moveRows(QModelIndex(), first, count, QModelIndex(), destination);
+}
+
+// Gathers a selection of rows in front of the row at destination, keeping their order
+// Each contiguous block of the selection is moved with its own move signal
+void SampleModel::moveItemsTo(const QList<int>& rows, int destination)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::MoveItemsTo);
+    journal << rows << destination;
+    std::vector<int> sortedRows;
+    sortedRows.reserve(rows.size());
+    for (const int row : rows)
+    {
+        if (isValidRow(row))
+        {
+            sortedRows.push_back(row);
+        }
+    }
+    std::sort(sortedRows.begin(), sortedRows.end());
+    sortedRows.erase(std::unique(sortedRows.begin(), sortedRows.end()), sortedRows.end());
+    destination = std::max(0, std::min(destination, rowCount()));
+
+    struct Block
+    {
+        int first;
+        int count;
+    };
+
+    std::vector<Block> blocks;
+    for (const int row : sortedRows)
+    {
+        if (!blocks.empty() && blocks.back().first + blocks.back().count == row)
+        {
+            ++blocks.back().count;
+        }
+        else
+        {
+            blocks.push_back({ row, 1 });
+        }
+    }
+
+    // Blocks above the destination move down in front of it, closest first,
+    // which leaves the rows of the blocks not yet moved where they were
+    int gather = destination;
+    for (auto itr = blocks.rbegin(); itr != blocks.rend(); ++itr)
+    {
+        if (itr->first < destination)
+        {
+            moveRows(QModelIndex(), itr->first, itr->count, QModelIndex(), gather);
+            gather -= itr->count;
+        }
+    }
+
+    // Blocks below the destination move up behind the gathered rows, closest first
+    int insert = destination;
+    for (const auto& block : blocks)
+    {
+        if (block.first >= destination)
+        {
+            if (block.first != insert)
+            {
+                moveRows(QModelIndex(), block.first, block.count, QModelIndex(), insert);
+            }
+            insert += block.count;
+        }
     }
 }
 
+// Object storage items store their row, which is kept up to date whenever rows shift
 int SampleModel::itemToRow(const SampleItem* item) const
 {
-    const auto itr = std::find_if(m_items.begin(), m_items.end(),
-        [item](const auto itemPtr) { return itemPtr == item; });
-    return itr != m_items.end() ? std::distance(m_items.begin(), itr) : -1;
+    const int row = item ? item->getRow() : -1;
+    return isValidRow(row) && m_store->item(row) == item ? row : -1;
+}
+
+const SampleStore& SampleModel::store() const
+{
+    return *m_store;
 }
 
 SampleItem* SampleModel::rowToItem(int row) const
 {
-    return row >= 0 && row < static_cast<int>(m_items.size())
-        ? m_items[row] : nullptr;
+    return isValidRow(row) ? m_store->item(row) : nullptr;
 }
 
-void SampleModel::tick()
+bool SampleModel::isValidRow(int row) const
 {
-    for (auto& item : m_items)
+    return row >= 0 && row < rowCount();
+}
+
+// Maps the rows of a drag payload to the current rows, rows that moved since the
+// drag started are found again by id and rows that were deleted are dropped
+std::vector<int> SampleModel::resolveRows(const SampleMimeData& data) const
+{
+    const auto& rows = data.rows();
+    const auto& ids = data.ids();
+    std::vector<int> result;
+    result.reserve(rows.size());
+
+    QHash<quint32, int> idRows;
+    for (size_t i = 0; i < rows.size(); ++i)
     {
-        item->tick();
+        if (isValidRow(rows[i]) && m_store->id(rows[i]) == ids[i])
+        {
+            result.push_back(rows[i]);
+            continue;
+        }
+
+        if (idRows.isEmpty())
+        {
+            idRows.reserve(rowCount());
+            for (int row = 0; row < rowCount(); ++row)
+            {
+                idRows.insert(m_store->id(row), row);
+            }
+        }
+
+        const auto itr = idRows.constFind(ids[i]);
+        if (itr != idRows.constEnd())
+        {
+            result.push_back(itr.value());
+        }
     }
+    return result;
 }
 
-void SampleModel::createItem(const QString& name)
+// Appends the dropped items and moves them into place as one block, returns the row of the first
+// Dropped rows are recorded with their state since it is written to the store directly
+int SampleModel::insertDroppedItems(const std::vector<SampleMimeData::Item>& items, int destination)
 {
-    auto onDataChanged = [this](const SampleItem* item)
+    const int first = m_store->count();
+    if (items.empty())
+    {
+        return first;
+    }
+
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::InsertItems);
+    journal << destination;
+    for (const auto& item : items)
     {
-        const int row = itemToRow(item);
-        if (row >= 0 && row < static_cast<int>(m_items.size()))
+        journal << static_cast<int>(item.state) << item.step << item.maxSteps << item.stepRate << item.name;
+    }
+
+    QStringList names;
+    names.reserve(static_cast<int>(items.size()));
+    for (const auto& item : items)
+    {
+        names.push_back(item.name);
+    }
+    createItems(names);
+
+    beginBatch();
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const int row = first + static_cast<int>(i);
+        if (items[i].maxSteps > 0)
         {
-            const auto& modelIndex = index(row);
-            emit dataChanged(modelIndex, modelIndex);
+            setItemMaxSteps(row, items[i].maxSteps);
         }
-    };
+        if (items[i].stepRate != 1)
+        {
+            setItemStepRate(row, items[i].stepRate);
+        }
+        const int step = std::max(0, std::min(items[i].step, m_store->maxSteps(row)));
+        m_store->setStep(row, step);
+        if (m_simulation)
+        {
+            m_simulation->setStep(row, step);
+        }
+        setItemState(row, items[i].state);
+    }
+    endBatch();
 
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-    m_items.push_back(new SampleItem(name, onDataChanged, this));
-    endInsertRows();
+    if (destination < first && rowCount() == m_store->count() &&
+        moveRows(QModelIndex(), first, static_cast<int>(items.size()), QModelIndex(), destination))
+    {
+        return destination;
+    }
+    return first;
+}
+
+// Threaded ticks own the item states, which are applied once the worker publishes them
+void SampleModel::setItemState(int row, SampleItem::State state)
+{
+    if (isValidRow(row))
+    {
+        if (state == SampleItem::STEPPING)
+        {
+            setStepping(true);
+        }
+        if (m_simulation)
+        {
+            m_simulation->setState(row, state);
+        }
+        else
+        {
+            m_store->setState(row, state);
+        }
+    }
+}
+
+SampleModel::StorageMode SampleModel::storageMode() const
+{
+    return m_storageMode;
+}
+
+void SampleModel::tick()
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::Tick);
+    tickRows();
+}
+
+// Not recorded on its own, stopping threaded ticks applies the last snapshot of the worker with it
+void SampleModel::tickRows()
+{
+    SAMPLE_TRACE_SCOPE("model", "tick");
+    SAMPLE_METRIC(const qint64 tickStart = m_metrics.now());
+    beginBatch();
+    bool stepping = m_stepping;
+    if (m_simulation)
+    {
+        // Only a snapshot that includes every command sent can tell whether items still step,
+        // the states it applies keep the active set of the store current
+        if (m_simulation->sync(*m_store) && m_simulation->isSynced())
+        {
+            stepping = m_store->activeCount() > 0;
+        }
+    }
+    else
+    {
+        // Only the active set is visited, stepping items always change,
+        // so a tick that changes nothing leaves nothing to step
+        if (m_tickPool)
+        {
+            m_tickPool->tick(*m_store, m_dirtyRows);
+        }
+        else
+        {
+            m_store->tickActiveRows(m_dirtyRows);
+        }
+        stepping = !m_dirtyRows.isEmpty();
+    }
+    SAMPLE_METRIC(m_metrics.recordTick(tickStart, m_dirtyRows.count()));
+    SAMPLE_TRACE_COUNTER("model", "changedRows", m_dirtyRows.count());
+    endBatch();
+    setStepping(stepping);
+}
+
+bool SampleModel::isStepping() const
+{
+    return m_stepping;
+}
+
+void SampleModel::setStepping(bool stepping)
+{
+    if (m_stepping != stepping)
+    {
+        m_stepping = stepping;
+        emit steppingChanged(stepping);
+    }
+}
+
+void SampleModel::setThreadedTick(bool threaded, int intervalMs)
+{
+    if (threaded && !m_simulation && !m_pagedStore)
+    {
+        m_simulation.reset(new SampleSimulation(*m_store, intervalMs));
+        m_simulation->start();
+    }
+    else if (!threaded && m_simulation)
+    {
+        m_simulation->stop();
+        tickRows();
+        m_simulation.reset();
+    }
+}
+
+bool SampleModel::threadedTick() const
+{
+    return m_simulation != nullptr;
+}
+
+// The file may still be mapped by the store, which would keep the rename from replacing it
+bool SampleModel::saveSnapshot(const QString& path)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::SaveSnapshot);
+    journal << path;
+    m_store->releaseSnapshot(path);
+    return SampleSnapshot::write(*m_store, path);
+}
+
+// Rows are replaced without change notifications, views are reset once
+// The journal records the restored rows after the restore, the file may be gone or saved over by the time it is replayed
+bool SampleModel::restoreSnapshot(const QString& path)
+{
+    auto snapshot = std::make_shared<SampleSnapshot>();
+    if (!snapshot->open(path))
+    {
+        return false;
+    }
+
+    {
+        SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::RestoreSnapshot);
+        journal << path;
+        SAMPLE_TRACE_SCOPE("model", "restoreSnapshot");
+        const bool threaded = threadedTick();
+        setThreadedTick(false);
+
+        beginResetModel();
+        m_store->setRowChangedFn(nullptr);
+        m_store->restore(snapshot);
+        connectStore();
+        m_fetchedRows = 0;
+        m_roleCache.clear();
+        m_dirtyRows.clear();
+        endResetModel();
+        m_summary->update();
+
+        setStepping(m_store->stats().stateCount(SampleItem::STEPPING) > 0);
+        setThreadedTick(threaded);
+    }
+    journalRows();
+    return true;
+}
+
+// Replaces the rows with those of a dataset file, views fetch them as they scroll
+bool SampleModel::openDataset(const QString& path)
+{
+    if (!m_pagedStore)
+    {
+        return false;
+    }
+
+    beginResetModel();
+    const bool opened = m_pagedStore->open(path);
+    m_fetchedRows = 0;
+    m_roleCache.clear();
+    m_dirtyRows.clear();
+    endResetModel();
+    m_summary->update();
+
+    // The paged store has no active set, its statistics count the stepping rows
+    setStepping(m_pagedStore->stats().stateCount(SampleItem::STEPPING) > 0);
+    return opened;
+}
+
+// Writes back the changes made to the opened dataset, or saves them as a new one
+bool SampleModel::saveDataset(const QString& path)
+{
+    return m_pagedStore && m_pagedStore->save(path);
+}
+
+void SampleModel::setPageCapacity(int pages)
+{
+    if (m_pagedStore)
+    {
+        m_pagedStore->setPageCapacity(pages);
+    }
+}
+
+void SampleModel::setTickThreads(int threadCount)
+{
+    if (threadCount <= 1 || m_pagedStore)
+    {
+        m_tickPool.reset();
+    }
+    else if (!m_tickPool || m_tickPool->threadCount() != threadCount)
+    {
+        m_tickPool.reset(new SampleTickPool(threadCount));
+    }
+}
+
+int SampleModel::tickThreads() const
+{
+    return m_tickPool ? m_tickPool->threadCount() : 1;
+}
+
+void SampleModel::createItem(const QString& name)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::CreateItem);
+    journal << name;
+    createItems(QStringList{ name });
 }
 
 void SampleModel::deleteItem(int row)
 {
-    if (row >= 0 && row < static_cast<int>(m_items.size()))
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::DeleteItem);
+    journal << row;
+    if (isValidRow(row))
     {
-        beginRemoveRows(QModelIndex(), row, row);
-        auto item = m_items.takeAt(row);
-        item->deleteLater();
-        endRemoveRows();
+        removeItemRows(row, 1);
     }
 }
 
 void SampleModel::startItemProgress(int row)
 {
-    if (auto item = rowToItem(row))
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StartItemProgress);
+    journal << row;
+    setItemState(row, SampleItem::STEPPING);
+}
+
+void SampleModel::stopItemProgress(int row)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StopItemProgress);
+    journal << row;
+    setItemState(row, SampleItem::STOPPED);
+}
+
+void SampleModel::pauseItemProgress(int row)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::PauseItemProgress);
+    journal << row;
+    setItemState(row, SampleItem::PAUSED);
+}
+
+// Completes the item on its next tick if it already reached the new maximum
+void SampleModel::setItemMaxSteps(int row, int maxSteps)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::SetItemMaxSteps);
+    journal << row << maxSteps;
+    if (isValidRow(row) && maxSteps > 0)
     {
-        item->start();
-        const auto& modelIndex = index(row);
-        emit dataChanged(modelIndex, modelIndex);
+        m_store->setMaxSteps(row, maxSteps);
+        if (m_simulation)
+        {
+            m_simulation->setMaxSteps(row, maxSteps);
+        }
     }
 }
 
-void SampleModel::stopItemProgress(int row)
+void SampleModel::setItemStepRate(int row, int stepRate)
 {
-    if (auto item = rowToItem(row))
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::SetItemStepRate);
+    journal << row << stepRate;
+    if (isValidRow(row) && stepRate > 0)
     {
-        item->stop();
-        const auto& modelIndex = index(row);
-        emit dataChanged(modelIndex, modelIndex);
+        m_store->setStepRate(row, stepRate);
+        if (m_simulation)
+        {
+            m_simulation->setStepRate(row, stepRate);
+        }
     }
 }
 
-void SampleModel::pauseItemProgress(int row)
+//===========================================================================================================
+// Bulk Methods
+//===========================================================================================================
+
+void SampleModel::createItems(const QStringList& names)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::CreateItems);
+    journal << names;
+    if (names.isEmpty())
+    {
+        return;
+    }
+
+    SAMPLE_TRACE_SCOPE("model", "createItems");
+    // Rows appended behind rows the views have not fetched yet are fetched with them later
+    const int first = m_store->count();
+    const int count = names.size();
+    const bool fetched = rowCount() == first;
+    if (fetched)
+    {
+        beginInsertRows(QModelIndex(), first, first + count - 1);
+    }
+    if (count > 1)
+    {
+        m_store->reserve(first + count);
+    }
+    for (const auto& name : names)
+    {
+        m_store->append(name);
+    }
+    if (fetched)
+    {
+        if (m_pagedStore)
+        {
+            m_fetchedRows += count;
+        }
+        endInsertRows();
+    }
+    m_summary->update();
+    SAMPLE_METRIC(m_metrics.recordInsert(count));
+
+    if (m_simulation)
+    {
+        m_simulation->insertRows(count);
+    }
+}
+
+void SampleModel::createItems(int count, const QString& namePrefix)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::CreateItemCount);
+    journal << count << namePrefix;
+    QStringList names;
+    names.reserve(count);
+    const int first = m_store->count();
+    for (int i = 0; i < count; ++i)
+    {
+        names.push_back(namePrefix + QString::number(first + i));
+    }
+    createItems(names);
+}
+
+// Rows are removed from the back so earlier rows keep their index
+void SampleModel::deleteItems(const QList<int>& rows)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::DeleteItems);
+    journal << rows;
+    std::vector<int> sortedRows;
+    sortedRows.reserve(rows.size());
+    for (const int row : rows)
+    {
+        if (isValidRow(row))
+        {
+            sortedRows.push_back(row);
+        }
+    }
+    std::sort(sortedRows.begin(), sortedRows.end(), std::greater<int>());
+    sortedRows.erase(std::unique(sortedRows.begin(), sortedRows.end()), sortedRows.end());
+
+    size_t i = 0;
+    while (i < sortedRows.size())
+    {
+        const int last = sortedRows[i];
+        int first = last;
+        while (++i < sortedRows.size() && sortedRows[i] == first - 1)
+        {
+            first = sortedRows[i];
+        }
+        removeItemRows(first, last - first + 1);
+    }
+}
+
+void SampleModel::deleteItemRange(int first, int count)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::DeleteItemRange);
+    journal << first << count;
+    first = std::max(first, 0);
+    count = std::min(count, rowCount() - first);
+    if (count > 0)
+    {
+        removeItemRows(first, count);
+    }
+}
+
+void SampleModel::startItems(const QList<int>& rows)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StartItems);
+    journal << rows;
+    setItemsState(rows, SampleItem::STEPPING);
+}
+
+void SampleModel::stopItems(const QList<int>& rows)
 {
-    if (auto item = rowToItem(row))
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StopItems);
+    journal << rows;
+    setItemsState(rows, SampleItem::STOPPED);
+}
+
+void SampleModel::pauseItems(const QList<int>& rows)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::PauseItems);
+    journal << rows;
+    setItemsState(rows, SampleItem::PAUSED);
+}
+
+void SampleModel::startItemsInState(int state)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StartItemsInState);
+    journal << state;
+    setItemsInState(static_cast<SampleItem::State>(state), SampleItem::STEPPING);
+}
+
+void SampleModel::stopItemsInState(int state)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::StopItemsInState);
+    journal << state;
+    setItemsInState(static_cast<SampleItem::State>(state), SampleItem::STOPPED);
+}
+
+void SampleModel::pauseItemsInState(int state)
+{
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::PauseItemsInState);
+    journal << state;
+    setItemsInState(static_cast<SampleItem::State>(state), SampleItem::PAUSED);
+}
+
+void SampleModel::setItemsState(const QList<int>& rows, SampleItem::State state)
+{
+    beginBatch();
+    for (const int row : rows)
+    {
+        setItemState(row, state);
+    }
+    endBatch();
+}
+
+void SampleModel::setItemsInState(SampleItem::State fromState, SampleItem::State state)
+{
+    beginBatch();
+    for (int row = 0; row < rowCount(); ++row)
+    {
+        if (m_store->state(row) == fromState)
+        {
+            setItemState(row, state);
+        }
+    }
+    endBatch();
+}
+
+void SampleModel::removeItemRows(int first, int count)
+{
+    SAMPLE_TRACE_SCOPE("model", "removeRows");
+    beginRemoveRows(QModelIndex(), first, first + count - 1);
+    m_store->remove(first, count);
+    m_roleCache.clear();
+    if (m_pagedStore)
+    {
+        m_fetchedRows -= count;
+    }
+    endRemoveRows();
+    m_summary->update();
+    SAMPLE_METRIC(m_metrics.recordRemove(count));
+
+    if (m_simulation)
     {
-        item->pause();
-        const auto& modelIndex = index(row);
-        emit dataChanged(modelIndex, modelIndex);
+        m_simulation->removeRows(first, count);
     }
+}
+
+//===========================================================================================================
+// Change Notification
+//===========================================================================================================
+
+void SampleModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void SampleModel::endBatch()
+{
+    if (m_batchDepth > 0 && --m_batchDepth == 0)
+    {
+        SAMPLE_TRACE_SCOPE("model", "flushChanges");
+        m_summary->update();
+        m_dirtyRows.flush([this](int first, int last, int changes)
+        {
+            if (m_batchUpdates)
+            {
+                emitRowsChanged(first, last, changes);
+            }
+            else
+            {
+                for (int row = first; row <= last; ++row)
+                {
+                    emitRowsChanged(row, row, changes);
+                }
+            }
+        });
+    }
+}
+
+void SampleModel::setBatchUpdates(bool batch)
+{
+    m_batchUpdates = batch;
+}
+
+bool SampleModel::batchUpdates() const
+{
+    return m_batchUpdates;
+}
+
+void SampleModel::setRoleCacheEnabled(bool enabled)
+{
+    m_roleCacheEnabled = enabled;
+    m_roleCache.clear();
+}
+
+bool SampleModel::roleCacheEnabled() const
+{
+    return m_roleCacheEnabled;
+}
+
+SampleMetrics* SampleModel::metrics() const
+{
+    return &m_metrics;
+}
+
+SampleSummary* SampleModel::summary() const
+{
+    return m_summary.get();
+}
+
+//===========================================================================================================
+// Journal
+//===========================================================================================================
+
+// Paged rows are not recorded, a journal of them is replayed against the same dataset
+bool SampleModel::startJournal(const QString& path)
+{
+    std::unique_ptr<SampleJournalWriter> writer(new SampleJournalWriter);
+    if (!writer->open(path, m_storageMode))
+    {
+        return false;
+    }
+    m_journal = std::move(writer);
+    journalRows();
+    return true;
+}
+
+// Records the rows present with their full state as one insertItems entry
+void SampleModel::journalRows()
+{
+    const int rows = m_store->count();
+    if (m_pagedStore || rows == 0)
+    {
+        return;
+    }
+
+    SampleJournalWriter::Call journal(m_journal.get(), SampleJournal::InsertItems);
+    journal << 0;
+    for (int row = 0; row < rows; ++row)
+    {
+        journal << static_cast<int>(m_store->state(row)) << m_store->step(row) << m_store->maxSteps(row)
+            << m_store->stepRate(row) << m_store->name(row);
+    }
+}
+
+void SampleModel::stopJournal()
+{
+    m_journal.reset();
+}
+
+bool SampleModel::isJournaling() const
+{
+    return m_journal != nullptr;
+}
+
+// Arguments missing from a damaged entry read as -1 and are rejected like any invalid row
+bool SampleModel::replay(const SampleJournal::Entry& entry)
+{
+    const auto intAt = [&entry](size_t i) { return i < entry.ints.size() ? entry.ints[i] : -1; };
+    const QString string = entry.strings.value(0);
+    size_t next = 0;
+    switch (entry.op)
+    {
+    case SampleJournal::Tick:
+        tick();
+        break;
+    case SampleJournal::CreateItem:
+        createItem(string);
+        break;
+    case SampleJournal::CreateItems:
+        createItems(entry.strings);
+        break;
+    case SampleJournal::CreateItemCount:
+        createItems(intAt(0), string);
+        break;
+    case SampleJournal::DeleteItem:
+        deleteItem(intAt(0));
+        break;
+    case SampleJournal::DeleteItems:
+        deleteItems(entry.intList(next));
+        break;
+    case SampleJournal::DeleteItemRange:
+        deleteItemRange(intAt(0), intAt(1));
+        break;
+    case SampleJournal::StartItemProgress:
+        startItemProgress(intAt(0));
+        break;
+    case SampleJournal::StopItemProgress:
+        stopItemProgress(intAt(0));
+        break;
+    case SampleJournal::PauseItemProgress:
+        pauseItemProgress(intAt(0));
+        break;
+    case SampleJournal::SetItemMaxSteps:
+        setItemMaxSteps(intAt(0), intAt(1));
+        break;
+    case SampleJournal::SetItemStepRate:
+        setItemStepRate(intAt(0), intAt(1));
+        break;
+    case SampleJournal::MoveItems:
+        moveItems(intAt(0), intAt(1));
+        break;
+    case SampleJournal::MoveItemRange:
+        moveItemRange(intAt(0), intAt(1), intAt(2));
+        break;
+    case SampleJournal::MoveItemsTo:
+    {
+        const QList<int> rows = entry.intList(next);
+        moveItemsTo(rows, intAt(next));
+        break;
+    }
+    case SampleJournal::StartItems:
+        startItems(entry.intList(next));
+        break;
+    case SampleJournal::StopItems:
+        stopItems(entry.intList(next));
+        break;
+    case SampleJournal::PauseItems:
+        pauseItems(entry.intList(next));
+        break;
+    case SampleJournal::StartItemsInState:
+        startItemsInState(intAt(0));
+        break;
+    case SampleJournal::StopItemsInState:
+        stopItemsInState(intAt(0));
+        break;
+    case SampleJournal::PauseItemsInState:
+        pauseItemsInState(intAt(0));
+        break;
+    case SampleJournal::SetName:
+        setData(index(intAt(0)), string, NameRole);
+        break;
+    case SampleJournal::InsertItems:
+        replayInsertItems(entry);
+        break;
+    case SampleJournal::RestoreSnapshot:
+        // The restored rows follow as an insertItems entry
+        deleteItemRange(0, rowCount());
+        break;
+    case SampleJournal::SaveSnapshot:
+    {
+        // The recorded file is left alone, the save is made to a temporary one
+        const QString path = QDir::temp().filePath("qtSampleReplay.snapshot");
+        saveSnapshot(path);
+        QFile::remove(path);
+        break;
+    }
+    default:
+        return false;
+    }
+    return true;
+}
+
+// Every row is its state, step, max steps and step rate after the destination, invalid states read as NONE
+void SampleModel::replayInsertItems(const SampleJournal::Entry& entry)
+{
+    const size_t fields = 4;
+    std::vector<SampleMimeData::Item> items;
+    items.reserve(entry.strings.size());
+    for (int i = 0; i < entry.strings.size(); ++i)
+    {
+        const size_t at = 1 + static_cast<size_t>(i) * fields;
+        if (at + fields > entry.ints.size())
+        {
+            break;
+        }
+        const int state = entry.ints[at];
+        items.push_back({ entry.strings[i],
+            static_cast<SampleItem::State>(state >= SampleItem::NONE && state <= SampleItem::STOPPED ? state : SampleItem::NONE),
+            entry.ints[at + 1], entry.ints[at + 2], entry.ints[at + 3] });
+    }
+    insertDroppedItems(items, entry.ints.empty() ? rowCount() : entry.ints[0]);
+}
+
+void SampleModel::markRowChanged(int row, int changes)
+{
+    if (m_batchDepth > 0)
+    {
+        m_dirtyRows.mark(row, changes);
+    }
+    else
+    {
+        emitRowsChanged(row, row, changes);
+        m_summary->update();
+    }
+}
+
+// Rows the views have not fetched yet are not notified
+void SampleModel::emitRowsChanged(int first, int last, int changes)
+{
+    last = std::min(last, rowCount() - 1);
+    if (first > last)
+    {
+        return;
+    }
+
+    const QVector<int> roles = changedRoles(changes);
+    quint32 roleMask = 0;
+    for (const int role : roles)
+    {
+        roleMask |= m_roleCache.roleBit(role);
+    }
+    m_roleCache.invalidate(first, last, roleMask);
+    // Views and the bindings of their delegates update while the signal is delivered
+    SAMPLE_TRACE_SCOPE("signal", "dataChanged");
+    emit dataChanged(index(first), index(last), roles);
+    SAMPLE_METRIC(m_metrics.recordDataChanged(last - first + 1));
+}
+
+QVector<int> SampleModel::changedRoles(int changes)
+{
+    QVector<int> roles;
+    if (changes & SampleItem::NameChange)
+    {
+        roles.push_back(NameRole);
+    }
+    if (changes & SampleItem::StateChange)
+    {
+        roles.push_back(StateDescRole);
+        roles.push_back(StateValueRole);
+    }
+    if (changes & SampleItem::StepChange)
+    {
+        roles.push_back(StepRole);
+    }
+    if (changes & SampleItem::MaxStepChange)
+    {
+        roles.push_back(MaxStepRole);
+    }
+    return roles;
 }
\ No newline at end of file
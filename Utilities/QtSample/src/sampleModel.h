@@ -1,27 +1,55 @@
 #pragma once
 
 #include "testClasses.h"
+#include "sampleDirtyTracker.h"
+#include "sampleStore.h"
+#include "sampleMimeData.h"
+#include "sampleRoleCache.h"
+#include "sampleMetrics.h"
+#include "sampleValueList.h"
+#include "sampleObjectPool.h"
+#include "sampleJournal.h"
+#include "sampleSummary.h"
 #include <qabstractitemmodel.h>
 #include <memory>
+#include <vector>
 #include <qbytearray.h>
 #include <qdatastream.h>
 #include <qmimedata.h>
 #include <qcolor.h>
 #include <qvector.h>
+#include <qqmllist.h>
 
 class SampleItem;
+class SampleSimulation;
+class SampleTickPool;
+class SamplePagedStore;
 
 class SampleModel : public QAbstractItemModel
 {
     Q_OBJECT
 
-    Q_PROPERTY(QList<int> intListTest MEMBER m_intListTest)
-    Q_PROPERTY(QVariantList colorListTest MEMBER m_colorListTest)
-    Q_PROPERTY(QList<QObject*> objectListTest MEMBER m_objectListTest)
+    Q_PROPERTY(SampleIntList* intListTest READ intListTest CONSTANT)
+    Q_PROPERTY(SampleColorList* colorListTest READ colorListTest CONSTANT)
+    Q_PROPERTY(QQmlListProperty<Test::Object> objectListTest READ objectListTest CONSTANT)
     Q_PROPERTY(Test::Gadget gadgetTest MEMBER m_gadgetTest)
+    Q_PROPERTY(bool stepping READ isStepping NOTIFY steppingChanged)
+    Q_PROPERTY(SampleMetrics* metrics READ metrics CONSTANT)
+    Q_PROPERTY(SampleSummary* summary READ summary CONSTANT)
 
 public:
+    /**
+    * Layout used to store the rows of the model
+    */
+    enum StorageMode
+    {
+        ObjectStorage,
+        ColumnStorage,
+        PagedStorage
+    };
+
     SampleModel(QObject* parent = nullptr);
+    SampleModel(StorageMode storageMode, QObject* parent = nullptr);
     virtual ~SampleModel();
     static void qmlRegisterTypes();
 
@@ -47,18 +75,30 @@ public:
     * Optional QAbstractItemModel
     */
     virtual QHash<int, QByteArray> roleNames() const override;
+    virtual QMap<int, QVariant> itemData(const QModelIndex& index) const override;
+    virtual bool canFetchMore(const QModelIndex& parent) const override;
+    virtual void fetchMore(const QModelIndex& parent) override;
     virtual bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
+    virtual bool moveRows(const QModelIndex& sourceParent, int sourceRow, int count,
+        const QModelIndex& destinationParent, int destinationChild) override;
 
     /**
     * Drag and Drop
     */
     static constexpr const char* MimeKey = "application/sample-model-item";
+    static constexpr const char* ItemModelMimeKey = "application/x-qabstractitemmodeldatalist";
     virtual QStringList mimeTypes() const override;
     virtual bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
     virtual bool canDropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) const override;
     virtual QMimeData* mimeData(const QModelIndexList& indexes) const override;
     virtual Qt::DropActions supportedDropActions() const override;
     virtual Qt::DropActions supportedDragActions() const override;
+    virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+    * Binary encoding of the rows of a drag payload, see SampleMimeData
+    */
+    QByteArray encodeItems(const SampleMimeData& data) const;
 
     /**
     * Custom Methods
@@ -68,22 +108,192 @@ public:
     Q_INVOKABLE void startItemProgress(int row);
     Q_INVOKABLE void stopItemProgress(int row);
     Q_INVOKABLE void pauseItemProgress(int row);
+    Q_INVOKABLE void setItemMaxSteps(int row, int maxSteps);
+    Q_INVOKABLE void setItemStepRate(int row, int stepRate);
     Q_INVOKABLE void moveItems(int oldIndex, int newIndex);
+    Q_INVOKABLE void moveItemRange(int first, int count, int destination);
+    Q_INVOKABLE void moveItemsTo(const QList<int>& rows, int destination);
+
+    /**
+    * Bulk Methods
+    * Each call notifies views with a single signal per contiguous block of rows
+    */
+    Q_INVOKABLE void createItems(const QStringList& names);
+    Q_INVOKABLE void createItems(int count, const QString& namePrefix = "Sample Item ");
+    Q_INVOKABLE void deleteItems(const QList<int>& rows);
+    Q_INVOKABLE void deleteItemRange(int first, int count);
+    Q_INVOKABLE void startItems(const QList<int>& rows);
+    Q_INVOKABLE void stopItems(const QList<int>& rows);
+    Q_INVOKABLE void pauseItems(const QList<int>& rows);
+    Q_INVOKABLE void startItemsInState(int state);
+    Q_INVOKABLE void stopItemsInState(int state);
+    Q_INVOKABLE void pauseItemsInState(int state);
+
     SampleItem* rowToItem(int row) const;
+
+    /**
+    * Rows as stored, for views that read them without going through data()
+    */
+    const SampleStore& store() const;
     int itemToRow(const SampleItem* item) const;
     void tick();
+    StorageMode storageMode() const;
+
+    /**
+    * Paged Storage
+    * Rows live in a dataset file of which only a bounded number of pages are kept in
+    * memory, views see rows as they fetch them while scrolling
+    * The dataset is only written by saveDataset, other changes are dropped with the store
+    * Threaded and parallel ticks are not available as pages are not shared between threads
+    */
+    static const int FetchRows = 1000;
+    bool openDataset(const QString& path);
+    bool saveDataset(const QString& path);
+    void setPageCapacity(int pages);
+
+    /**
+    * Snapshots
+    * Saves the rows to a binary snapshot and replaces them with those of one,
+    * restoring copies every row, column storage only leaves the names in the mapped
+    * snapshot until a snapshot is saved over the file it was restored from
+    */
+    Q_INVOKABLE bool saveSnapshot(const QString& path);
+    Q_INVOKABLE bool restoreSnapshot(const QString& path);
+
+    /**
+    * Threaded Tick
+    * Steps items on a worker thread, tick then only applies the latest published snapshot
+    */
+    void setThreadedTick(bool threaded, int intervalMs = 10);
+    bool threadedTick() const;
+
+    /**
+    * Parallel Tick
+    * Splits stepping of large item counts across threads, one or less ticks serially
+    */
+    void setTickThreads(int threadCount);
+    int tickThreads() const;
+
+    /**
+    * Stepping
+    * True while any item may still step, set when an item is started and cleared
+    * by the first tick that finds nothing to step, so schedulers can stop ticking
+    */
+    bool isStepping() const;
+
+    /**
+    * Role Values
+    * multiData fills every requested role of a row in one call, values read through
+    * it or data() are cached until a change to their row and role is notified
+    */
+    struct RoleData
+    {
+        int role;
+        QVariant data;
+    };
+
+    void multiData(const QModelIndex& index, std::vector<RoleData>& roleData) const;
+    void setRoleCacheEnabled(bool enabled);
+    bool roleCacheEnabled() const;
+
+    /**
+    * Metrics
+    * Counters and latency histograms of ticks, notifications, data() calls and row
+    * operations, recorded while enabled in builds with SAMPLE_METRICS
+    */
+    SampleMetrics* metrics() const;
+
+    /**
+    * Summary
+    * Counts per state, total steps and a progress histogram of all rows, kept current by the
+    * store as rows change and published once per batch, so reading them never visits the rows
+    */
+    SampleSummary* summary() const;
+
+    /**
+    * Journal
+    * Records every call of the invokable methods, name edits, drops and ticks to a journal file,
+    * starting with the rows already present and their states, steps, max steps and step rates.
+    * Replaying an entry makes the recorded call again, see SampleJournal
+    */
+    bool startJournal(const QString& path);
+    void stopJournal();
+    bool isJournaling() const;
+    bool replay(const SampleJournal::Entry& entry);
+
+    /**
+    * Change Notification
+    * Changes made while batching are coalesced into one dataChanged per range of rows
+    * Disabling batch updates emits every change immediately, mainly for benchmarking
+    */
+    void beginBatch();
+    void endBatch();
+    void setBatchUpdates(bool batch);
+    bool batchUpdates() const;
 
     /**
     * Test Methods
+    * The test lists are read by QML one element at a time instead of being copied on access
     */
-    void fillTestItems();
+    void fillTestItems(int count = 3);
+    SampleIntList* intListTest();
+    SampleColorList* colorListTest();
+    QQmlListProperty<Test::Object> objectListTest();
     Q_INVOKABLE QObject* returnObject();
     Q_INVOKABLE QList<QObject*> returnObjectList();
 
+    /**
+    * Allocation free alternatives for hot call sites, a gadget is returned by value and
+    * pooled objects are recycled once released instead of being left to the garbage collector
+    */
+    Q_INVOKABLE Test::Gadget returnGadget(int id = -1) const;
+    Q_INVOKABLE QObject* acquireObject(int id = -1);
+    Q_INVOKABLE QList<QObject*> acquireObjectList(int count, int firstId = 0);
+    Q_INVOKABLE void releaseObject(QObject* object);
+    Q_INVOKABLE void releaseObjectList(const QList<QObject*>& objects);
+    const SampleObjectPool& objectPool() const;
+
+signals:
+    void steppingChanged(bool stepping);
+
 private:
-    QVector<SampleItem*> m_items;
+    bool isValidRow(int row) const;
+    QVariant roleValue(int row, int role) const;
+    void setStepping(bool stepping);
+    void connectStore();
+    std::vector<int> resolveRows(const SampleMimeData& data) const;
+    int insertDroppedItems(const std::vector<SampleMimeData::Item>& items, int destination);
+    void tickRows();
+    void journalRows();
+    void replayInsertItems(const SampleJournal::Entry& entry);
+    void setItemState(int row, SampleItem::State state);
+    void setItemsState(const QList<int>& rows, SampleItem::State state);
+    void setItemsInState(SampleItem::State fromState, SampleItem::State state);
+    void removeItemRows(int first, int count);
+    void markRowChanged(int row, int changes);
+    void emitRowsChanged(int first, int last, int changes);
+    static QVector<int> changedRoles(int changes);
+    static int objectListCount(QQmlListProperty<Test::Object>* list);
+    static Test::Object* objectListAt(QQmlListProperty<Test::Object>* list, int index);
+
+    StorageMode m_storageMode;
+    std::unique_ptr<SampleStore> m_store;
+    std::unique_ptr<SampleSimulation> m_simulation;
+    std::unique_ptr<SampleTickPool> m_tickPool;
+    SamplePagedStore* m_pagedStore = nullptr;
+    int m_fetchedRows = 0;
+    SampleDirtyTracker m_dirtyRows;
+    int m_batchDepth = 0;
+    bool m_batchUpdates = true;
+    bool m_stepping = false;
+    mutable SampleRoleCache m_roleCache;
+    bool m_roleCacheEnabled = true;
+    mutable SampleMetrics m_metrics;
     Test::Gadget m_gadgetTest;
-    QList<int> m_intListTest;
-    QVariantList m_colorListTest;
-    QList<QObject*> m_objectListTest;
+    SampleIntList m_intListTest;
+    SampleColorList m_colorListTest;
+    QVector<Test::Object*> m_objectListTest;
+    SampleObjectPool m_objectPool;
+    std::unique_ptr<SampleJournalWriter> m_journal;
+    std::unique_ptr<SampleSummary> m_summary;
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "sampleNameIndex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    const QChar StartMarker(static_cast<ushort>(1));
+
+    QString padded(const QString& folded)
+    {
+        QString text;
+        text.reserve(folded.size() + 2);
+        text.append(StartMarker);
+        text.append(StartMarker);
+        text.append(folded);
+        return text;
+    }
+}
+
+QString SampleNameIndex::fold(const QString& name)
+{
+    return name.toCaseFolded();
+}
+
+int SampleNameIndex::add(const QString& name)
+{
+    const int entry = static_cast<int>(m_live.size());
+    m_live.push_back(true);
+    ++m_liveCount;
+
+    std::vector<quint64> trigrams;
+    appendTrigrams(padded(fold(name)), trigrams);
+    for (const quint64 trigram : trigrams)
+    {
+        m_entries[trigram].push_back(entry);
+    }
+    return entry;
+}
+
+void SampleNameIndex::remove(int entry)
+{
+    if (entry >= 0 && entry < entryCount() && m_live[entry])
+    {
+        m_live[entry] = false;
+        --m_liveCount;
+    }
+}
+
+void SampleNameIndex::clear()
+{
+    m_entries.clear();
+    m_live.clear();
+    m_liveCount = 0;
+}
+
+void SampleNameIndex::reserve(int entries)
+{
+    m_live.reserve(entries);
+}
+
+int SampleNameIndex::entryCount() const
+{
+    return static_cast<int>(m_live.size());
+}
+
+int SampleNameIndex::liveCount() const
+{
+    return m_liveCount;
+}
+
+// Intersects the lists of the trigrams starting with the shortest, a much longer list is
+// probed with binary searches instead of being walked
+bool SampleNameIndex::find(const QString& folded, bool prefix, std::vector<int>& entries) const
+{
+    entries.clear();
+    std::vector<quint64> trigrams;
+    appendTrigrams(prefix ? padded(folded) : folded, trigrams);
+    if (trigrams.empty())
+    {
+        return false;
+    }
+
+    std::vector<const std::vector<int>*> lists;
+    for (const quint64 trigram : trigrams)
+    {
+        const auto found = m_entries.constFind(trigram);
+        if (found == m_entries.constEnd())
+        {
+            return true;
+        }
+        lists.push_back(&found.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::vector<int>* left, const std::vector<int>* right)
+    {
+        return left->size() < right->size();
+    });
+
+    for (const int entry : *lists.front())
+    {
+        if (m_live[entry])
+        {
+            entries.push_back(entry);
+        }
+    }
+    for (size_t i = 1; i < lists.size() && !entries.empty(); ++i)
+    {
+        const std::vector<int>& list = *lists[i];
+        std::vector<int> matched;
+        matched.reserve(entries.size());
+        if (entries.size() * 16 < list.size())
+        {
+            for (const int entry : entries)
+            {
+                if (std::binary_search(list.begin(), list.end(), entry))
+                {
+                    matched.push_back(entry);
+                }
+            }
+        }
+        else
+        {
+            std::set_intersection(entries.begin(), entries.end(), list.begin(), list.end(), std::back_inserter(matched));
+        }
+        entries.swap(matched);
+    }
+    return true;
+}
+
+// Markers only occur at the start of a padded name, so the trigram ending a padded
+// prefix of up to two characters can only be found at the start as well
+bool SampleNameIndex::isExact(int length, bool prefix)
+{
+    return prefix ? length <= 2 : length == 3;
+}
+
+void SampleNameIndex::appendTrigrams(const QString& text, std::vector<quint64>& trigrams)
+{
+    const int size = text.size();
+    for (int i = 0; i + 2 < size; ++i)
+    {
+        trigrams.push_back(static_cast<quint64>(text[i].unicode()) << 32 |
+            static_cast<quint64>(text[i + 1].unicode()) << 16 | text[i + 2].unicode());
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <qhash.h>
+#include <qstring.h>
+#include <vector>
+
+/**
+* Trigram index over case folded names for substring and prefix search
+* Every name added becomes an entry numbered in the order added, listed under each
+* of its trigrams. Names are padded with two start markers so a prefix is found
+* through the trigrams of the padded prefix. Entries only ever append to the lists,
+* keeping them sorted, removed entries stay listed until the index is rebuilt
+*/
+class SampleNameIndex
+{
+public:
+    static QString fold(const QString& name);
+
+    /**
+    * Returns the entry of the name
+    */
+    int add(const QString& name);
+    void remove(int entry);
+    void clear();
+    void reserve(int entries);
+
+    /**
+    * Number of entries added since the last clear, removed ones included
+    */
+    int entryCount() const;
+    int liveCount() const;
+
+    /**
+    * Finds the live entries holding every trigram of the folded text, in ascending order
+    * These include every entry that contains or, with prefix, starts with the text, and
+    * only those when the text is a single trigram. Returns false if the text is too
+    * short to be looked up
+    */
+    bool find(const QString& folded, bool prefix, std::vector<int>& entries) const;
+
+    /**
+    * True if find returns exactly the matching entries for text of this length
+    */
+    static bool isExact(int length, bool prefix);
+
+private:
+    static void appendTrigrams(const QString& text, std::vector<quint64>& trigrams);
+
+    QHash<quint64, std::vector<int>> m_entries;
+    std::vector<bool> m_live;
+    int m_liveCount = 0;
+};
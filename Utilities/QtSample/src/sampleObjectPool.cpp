@@ -0,0 +1,53 @@
+#include "sampleObjectPool.h"
+#include <qqmlengine.h>
+
+SampleObjectPool::SampleObjectPool(QObject* owner)
+    : m_owner(owner)
+{
+}
+
+// Objects are children of the owner, which deletes them
+SampleObjectPool::~SampleObjectPool() = default;
+
+Test::Object* SampleObjectPool::acquire(int id)
+{
+    Test::Object* object = nullptr;
+    if (!m_free.empty())
+    {
+        object = m_free.back();
+        m_free.pop_back();
+        object->setId(id);
+        ++m_reused;
+    }
+    else
+    {
+        object = new Test::Object(id, m_owner);
+        QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
+        ++m_created;
+    }
+    m_acquired.insert(object);
+    return object;
+}
+
+void SampleObjectPool::release(QObject* object)
+{
+    if (m_acquired.remove(object))
+    {
+        m_free.push_back(static_cast<Test::Object*>(object));
+    }
+}
+
+int SampleObjectPool::available() const
+{
+    return static_cast<int>(m_free.size());
+}
+
+quint64 SampleObjectPool::created() const
+{
+    return m_created;
+}
+
+quint64 SampleObjectPool::reused() const
+{
+    return m_reused;
+}
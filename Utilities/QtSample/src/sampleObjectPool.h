@@ -0,0 +1,34 @@
+#pragma once
+#include "testClasses.h"
+#include <qset.h>
+#include <vector>
+
+/**
+* Recycles the Test::Objects handed to QML so hot call sites do not allocate one per call
+* Objects stay owned by the pool's owner rather than the JS engine, so the garbage
+* collector never has to destroy them, callers hand them back through release
+*/
+class SampleObjectPool
+{
+public:
+    explicit SampleObjectPool(QObject* owner);
+    ~SampleObjectPool();
+
+    Test::Object* acquire(int id);
+
+    /**
+    * Returns an object to the pool, objects the pool did not hand out are ignored
+    */
+    void release(QObject* object);
+
+    int available() const;
+    quint64 created() const;
+    quint64 reused() const;
+
+private:
+    QObject* m_owner;
+    std::vector<Test::Object*> m_free;
+    QSet<QObject*> m_acquired;
+    quint64 m_created = 0;
+    quint64 m_reused = 0;
+};
@@ -0,0 +1,236 @@
+#include "sampleObjectStore.h"
+#include "sampleDirtyTracker.h"
+#include <algorithm>
+
+SampleObjectStore::SampleObjectStore() = default;
+SampleObjectStore::~SampleObjectStore()
+{
+    qDeleteAll(m_items);
+}
+
+int SampleObjectStore::count() const
+{
+    return static_cast<int>(m_items.size());
+}
+
+QString SampleObjectStore::name(int row) const
+{
+    return m_items[row]->getName();
+}
+
+SampleItem::State SampleObjectStore::state(int row) const
+{
+    return m_items[row]->getState();
+}
+
+int SampleObjectStore::step(int row) const
+{
+    return m_items[row]->getStep();
+}
+
+int SampleObjectStore::maxSteps(int row) const
+{
+    return m_items[row]->getMaxSteps();
+}
+
+int SampleObjectStore::stepRate(int row) const
+{
+    return m_items[row]->getStepRate();
+}
+
+quint32 SampleObjectStore::id(int row) const
+{
+    return m_items[row]->getId();
+}
+
+void SampleObjectStore::setName(int row, const QString& name)
+{
+    m_items[row]->setName(name);
+    rowChanged(row, SampleItem::NameChange);
+}
+
+// Items report their own state changes through their changed callback, which also
+// keeps the active set up to date, the statistics are updated first so they are current by then
+void SampleObjectStore::setState(int row, SampleItem::State state)
+{
+    SampleItem* item = m_items[row];
+    if (item->getState() != state)
+    {
+        m_stats.changeRow(item->getState(), item->getStep(), item->getMaxSteps(), state, item->getStep(), item->getMaxSteps());
+        item->setState(state);
+    }
+}
+
+void SampleObjectStore::setStep(int row, int step)
+{
+    if (m_items[row]->getStep() != step)
+    {
+        const SampleItem* item = m_items[row];
+        m_stats.changeRow(item->getState(), item->getStep(), item->getMaxSteps(), item->getState(), step, item->getMaxSteps());
+        m_items[row]->setStep(step);
+        rowChanged(row, SampleItem::StepChange);
+    }
+}
+
+void SampleObjectStore::setMaxSteps(int row, int maxSteps)
+{
+    if (m_items[row]->getMaxSteps() != maxSteps)
+    {
+        const SampleItem* item = m_items[row];
+        m_stats.changeRow(item->getState(), item->getStep(), item->getMaxSteps(), item->getState(), item->getStep(), maxSteps);
+        m_items[row]->setMaxSteps(maxSteps);
+        rowChanged(row, SampleItem::MaxStepChange);
+    }
+}
+
+void SampleObjectStore::setStepRate(int row, int stepRate)
+{
+    m_items[row]->setStepRate(stepRate);
+}
+
+void SampleObjectStore::append(const QString& name)
+{
+    auto onDataChanged = [this](const SampleItem* item)
+    {
+        const int row = item->getRow();
+        if (row >= 0 && row < count() && m_items[row] == item)
+        {
+            updateActive(m_items[row]);
+            rowChanged(row, SampleItem::StateChange);
+        }
+    };
+
+    m_items.push_back(new SampleItem(name, onDataChanged));
+    m_items.back()->setRow(count() - 1);
+    m_items.back()->setId(m_nextId++);
+    m_stats.addRow(m_items.back()->getState(), m_items.back()->getStep(), m_items.back()->getMaxSteps());
+}
+
+void SampleObjectStore::reserve(int count)
+{
+    m_items.reserve(count);
+}
+
+// Items never reach QML, so nothing outlives their row and they are deleted right away,
+// a deferred delete would wait for an event loop the bench never runs
+void SampleObjectStore::remove(int row, int count)
+{
+    for (int i = row; i < row + count; ++i)
+    {
+        removeActive(m_items[i]);
+        m_stats.removeRow(m_items[i]->getState(), m_items[i]->getStep(), m_items[i]->getMaxSteps());
+        delete m_items[i];
+    }
+    m_items.remove(row, count);
+    updateRows(row, this->count() - 1);
+}
+
+// Rotates the items into place so the vector is only shifted once
+void SampleObjectStore::move(int from, int count, int to)
+{
+    if (from < to)
+    {
+        std::rotate(m_items.begin() + from, m_items.begin() + from + count, m_items.begin() + to + count);
+        updateRows(from, to + count - 1);
+    }
+    else if (from > to)
+    {
+        std::rotate(m_items.begin() + to, m_items.begin() + from, m_items.begin() + from + count);
+        updateRows(to, from + count - 1);
+    }
+}
+
+void SampleObjectStore::tick(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        stepItem(m_items[row], dirtyRows, m_stats);
+    }
+}
+
+// Steps the item, noting how its step and state changed
+void SampleObjectStore::stepItem(SampleItem* item, SampleDirtyTracker& dirtyRows, SampleStats& stats)
+{
+    const SampleItem::State state = item->getState();
+    const int step = item->getStep();
+    if (const int changes = item->tick())
+    {
+        stats.changeRow(state, step, item->getMaxSteps(), item->getState(), item->getStep(), item->getMaxSteps());
+        dirtyRows.mark(item->getRow(), changes);
+    }
+}
+
+SampleItem* SampleObjectStore::item(int row) const
+{
+    return m_items[row];
+}
+
+//===========================================================================================================
+// Active Set
+//===========================================================================================================
+
+int SampleObjectStore::activeCount() const
+{
+    return static_cast<int>(m_activeItems.size());
+}
+
+// Items carry their row, so moving rows leaves the set untouched
+void SampleObjectStore::tickActive(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    SampleStats delta;
+    for (int slot = first; slot <= last; ++slot)
+    {
+        stepItem(m_activeItems[slot], dirtyRows, delta);
+    }
+    mergeStats(delta);
+}
+
+// Swapping from the back keeps the entries not yet visited ahead of the cursor
+void SampleObjectStore::finishActive()
+{
+    for (int slot = activeCount() - 1; slot >= 0; --slot)
+    {
+        if (m_activeItems[slot]->getState() != SampleItem::STEPPING)
+        {
+            removeActive(m_activeItems[slot]);
+        }
+    }
+}
+
+void SampleObjectStore::updateActive(SampleItem* item)
+{
+    const bool stepping = item->getState() == SampleItem::STEPPING;
+    if (stepping && item->getActiveSlot() < 0)
+    {
+        item->setActiveSlot(activeCount());
+        m_activeItems.push_back(item);
+    }
+    else if (!stepping)
+    {
+        removeActive(item);
+    }
+}
+
+void SampleObjectStore::removeActive(SampleItem* item)
+{
+    const int slot = item->getActiveSlot();
+    if (slot < 0)
+    {
+        return;
+    }
+
+    SampleItem* last = m_activeItems.back();
+    m_activeItems[slot] = last;
+    last->setActiveSlot(slot);
+    m_activeItems.pop_back();
+    item->setActiveSlot(-1);
+}
+
+void SampleObjectStore::updateRows(int first, int last)
+{
+    last = std::min(last, count() - 1);
+    for (int row = first; row <= last; ++row)
+    {
+        m_items[row]->setRow(row);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "sampleStore.h"
+#include <qvector.h>
+#include <vector>
+
+/**
+* Stores each row as a heap allocated SampleItem
+* Stepping items are kept in an active set, each item holds its slot in it
+*/
+class SampleObjectStore : public SampleStore
+{
+public:
+    SampleObjectStore();
+    virtual ~SampleObjectStore();
+
+    virtual int count() const override;
+    virtual QString name(int row) const override;
+    virtual SampleItem::State state(int row) const override;
+    virtual int step(int row) const override;
+    virtual int maxSteps(int row) const override;
+    virtual int stepRate(int row) const override;
+    virtual quint32 id(int row) const override;
+
+    virtual void setName(int row, const QString& name) override;
+    virtual void setState(int row, SampleItem::State state) override;
+    virtual void setStep(int row, int step) override;
+    virtual void setMaxSteps(int row, int maxSteps) override;
+    virtual void setStepRate(int row, int stepRate) override;
+
+    virtual void reserve(int count) override;
+    virtual void append(const QString& name) override;
+    virtual void remove(int row, int count) override;
+    virtual void move(int from, int count, int to) override;
+
+    virtual void tick(int first, int last, SampleDirtyTracker& dirtyRows) override;
+    virtual SampleItem* item(int row) const override;
+
+    virtual int activeCount() const override;
+    virtual void tickActive(int first, int last, SampleDirtyTracker& dirtyRows) override;
+    virtual void finishActive() override;
+
+private:
+    static void stepItem(SampleItem* item, SampleDirtyTracker& dirtyRows, SampleStats& stats);
+    void updateRows(int first, int last);
+    void updateActive(SampleItem* item);
+    void removeActive(SampleItem* item);
+
+    QVector<SampleItem*> m_items;
+    std::vector<SampleItem*> m_activeItems;
+    quint32 m_nextId = 0;
+};
@@ -0,0 +1,592 @@
+#include "samplePagedStore.h"
+#include "sampleDirtyTracker.h"
+#include <qsavefile.h>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+namespace
+{
+    // "SMPD" read as a little endian integer
+    const quint32 DatasetMagic = 0x44504D53;
+    const quint16 DatasetVersion = 1;
+}
+
+// Changed pages of any dataset go to a scratch file removed with the store
+SamplePagedStore::SamplePagedStore()
+{
+    if (!m_scratch.open())
+    {
+        qWarning("Failed to create the scratch file: %s", qPrintable(m_scratch.errorString()));
+    }
+}
+
+SamplePagedStore::~SamplePagedStore()
+{
+    close();
+}
+
+bool SamplePagedStore::open(const QString& path)
+{
+    close();
+
+    m_dataset.setFileName(path);
+    Header header = {};
+    if (!m_dataset.open(QIODevice::ReadOnly) ||
+        m_dataset.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header) ||
+        header.magic != DatasetMagic || header.version != DatasetVersion ||
+        header.recordSize != sizeof(Record) ||
+        m_dataset.size() < recordOffset(static_cast<int>(header.rowCount)))
+    {
+        // The store stays empty on its scratch file, rows added afterwards are kept
+        m_dataset.close();
+        return false;
+    }
+
+    m_count = static_cast<int>(header.rowCount);
+    m_recordCount = m_count;
+    m_datasetRecords = m_count;
+    m_nextId = header.nextId;
+
+    // Count the stepping rows of every page and gather the statistics, reading the file once without caching it
+    m_steppingRecords.assign((m_count + PageRows - 1) / PageRows, 0);
+    std::vector<Record> records(PageRows);
+    for (int first = 0; first < m_count; first += PageRows)
+    {
+        const int rows = std::min(PageRows, m_count - first);
+        if (readRecords(m_dataset, first, records.data(), rows) != static_cast<qint64>(rows * sizeof(Record)))
+        {
+            close();
+            return false;
+        }
+        for (int i = 0; i < rows; ++i)
+        {
+            m_stats.addRow(static_cast<SampleItem::State>(records[i].state), records[i].step, records[i].maxSteps);
+            if (records[i].state == SampleItem::STEPPING)
+            {
+                ++m_steppingRecords[first / PageRows];
+            }
+        }
+    }
+    return true;
+}
+
+// Drops the rows along with every change made since opening, the dataset itself is never written
+void SamplePagedStore::close()
+{
+    resetPages();
+    m_dataset.close();
+    m_count = 0;
+    m_recordCount = 0;
+    m_datasetRecords = 0;
+    m_nextId = 0;
+    m_scratchPages.clear();
+    m_steppingRecords.clear();
+    m_mapped = false;
+    m_rowRecords.clear();
+    m_recordRows.clear();
+    m_freeRecords.clear();
+    m_stats.clear();
+
+    if (m_scratch.isOpen())
+    {
+        m_scratch.resize(0);
+    }
+}
+
+// Writing in row order leaves the saved dataset without holes, so rows are the records again once it is opened
+bool SamplePagedStore::save(const QString& path)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || !writeHeader(file, m_count, m_nextId))
+    {
+        return false;
+    }
+
+    std::vector<Record> records;
+    records.reserve(PageRows);
+    for (int first = 0; first < m_count; first += PageRows)
+    {
+        records.clear();
+        const int last = std::min(first + PageRows, m_count);
+        for (int row = first; row < last; ++row)
+        {
+            records.push_back(record(row));
+        }
+        if (!writeRecords(file, records.data(), static_cast<int>(records.size())))
+        {
+            file.cancelWriting();
+            return false;
+        }
+    }
+
+    // The dataset is closed first so the commit can replace it when saving over it
+    const bool reading = m_dataset.isOpen();
+    m_dataset.close();
+    if (!file.commit())
+    {
+        if (reading)
+        {
+            m_dataset.open(QIODevice::ReadOnly);
+        }
+        return false;
+    }
+    return open(path);
+}
+
+bool SamplePagedStore::createDataset(const QString& path, int count, const QString& namePrefix)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        !writeHeader(file, count, static_cast<quint32>(count)))
+    {
+        return false;
+    }
+
+    std::vector<Record> records;
+    records.reserve(PageRows);
+    for (int first = 0; first < count; first += PageRows)
+    {
+        records.clear();
+        const int last = std::min(first + PageRows, count);
+        for (int row = first; row < last; ++row)
+        {
+            records.push_back(makeRecord(static_cast<quint32>(row), namePrefix + QString::number(row)));
+        }
+        if (!writeRecords(file, records.data(), static_cast<int>(records.size())))
+        {
+            return false;
+        }
+    }
+    return file.flush();
+}
+
+void SamplePagedStore::setPageCapacity(int pages)
+{
+    m_pageCapacity = std::max(1, pages);
+    evictPages();
+}
+
+int SamplePagedStore::pageCapacity() const
+{
+    return m_pageCapacity;
+}
+
+int SamplePagedStore::residentPages() const
+{
+    return static_cast<int>(m_pages.size());
+}
+
+//===========================================================================================================
+// Rows
+//===========================================================================================================
+
+int SamplePagedStore::count() const
+{
+    return m_count;
+}
+
+QString SamplePagedStore::name(int row) const
+{
+    const Record& cached = record(row);
+    return QString::fromUtf8(cached.name, cached.nameSize);
+}
+
+SampleItem::State SamplePagedStore::state(int row) const
+{
+    return static_cast<SampleItem::State>(record(row).state);
+}
+
+int SamplePagedStore::step(int row) const
+{
+    return record(row).step;
+}
+
+int SamplePagedStore::maxSteps(int row) const
+{
+    return record(row).maxSteps;
+}
+
+int SamplePagedStore::stepRate(int row) const
+{
+    return std::max<int>(record(row).stepRate, 1);
+}
+
+quint32 SamplePagedStore::id(int row) const
+{
+    return record(row).id;
+}
+
+void SamplePagedStore::setName(int row, const QString& name)
+{
+    writeName(writableRecord(row), name);
+    rowChanged(row, SampleItem::NameChange);
+}
+
+void SamplePagedStore::setState(int row, SampleItem::State state)
+{
+    const int index = recordIndex(row);
+    Record& cached = writableRecordAt(index);
+    if (cached.state != state)
+    {
+        m_stats.changeRow(static_cast<SampleItem::State>(cached.state), cached.step, cached.maxSteps, state, cached.step, cached.maxSteps);
+        countState(index, cached.state, -1);
+        cached.state = static_cast<quint8>(state);
+        countState(index, cached.state, 1);
+        rowChanged(row, SampleItem::StateChange);
+    }
+}
+
+void SamplePagedStore::setStep(int row, int step)
+{
+    Record& cached = writableRecord(row);
+    if (cached.step != step)
+    {
+        m_stats.changeRow(static_cast<SampleItem::State>(cached.state), cached.step, cached.maxSteps,
+            static_cast<SampleItem::State>(cached.state), step, cached.maxSteps);
+        cached.step = step;
+        rowChanged(row, SampleItem::StepChange);
+    }
+}
+
+void SamplePagedStore::setMaxSteps(int row, int maxSteps)
+{
+    Record& cached = writableRecord(row);
+    if (cached.maxSteps != maxSteps)
+    {
+        m_stats.changeRow(static_cast<SampleItem::State>(cached.state), cached.step, cached.maxSteps,
+            static_cast<SampleItem::State>(cached.state), cached.step, maxSteps);
+        cached.maxSteps = maxSteps;
+        rowChanged(row, SampleItem::MaxStepChange);
+    }
+}
+
+void SamplePagedStore::setStepRate(int row, int stepRate)
+{
+    writableRecord(row).stepRate = static_cast<quint16>(std::min(stepRate, 0xFFFF));
+}
+
+// Records are written to the scratch file as pages are evicted, there is nothing to reserve
+void SamplePagedStore::reserve(int count)
+{
+    Q_UNUSED(count);
+}
+
+// Holes left by removed rows are filled first, so records only grow past the rows that exist
+void SamplePagedStore::append(const QString& name)
+{
+    const int row = m_count++;
+    int index = m_recordCount;
+    if (!m_freeRecords.empty())
+    {
+        index = m_freeRecords.back();
+        m_freeRecords.pop_back();
+    }
+    else
+    {
+        ++m_recordCount;
+        if (static_cast<int>(m_steppingRecords.size()) <= index / PageRows)
+        {
+            m_steppingRecords.push_back(0);
+        }
+        if (m_mapped)
+        {
+            m_recordRows.push_back(-1);
+        }
+    }
+
+    if (m_mapped)
+    {
+        m_rowRecords.push_back(index);
+        m_recordRows[index] = row;
+    }
+    writableRecordAt(index) = makeRecord(m_nextId++, name);
+    m_stats.addRow(SampleItem::NONE, 0, SampleItem::DefaultMaxSteps);
+}
+
+// Only the index shifts, the removed records are left in place as holes
+void SamplePagedStore::remove(int row, int count)
+{
+    mapRows();
+    for (int i = row; i < row + count; ++i)
+    {
+        const int index = m_rowRecords[i];
+        const Record& removed = recordAt(index);
+        m_stats.removeRow(static_cast<SampleItem::State>(removed.state), removed.step, removed.maxSteps);
+        countState(index, removed.state, -1);
+        m_recordRows[index] = -1;
+        m_freeRecords.push_back(index);
+    }
+
+    m_rowRecords.erase(m_rowRecords.begin() + row, m_rowRecords.begin() + row + count);
+    m_count -= count;
+    updateRecordRows(row, m_count - 1);
+}
+
+// Rotates the index, records are not read or written
+void SamplePagedStore::move(int from, int count, int to)
+{
+    if (from == to)
+    {
+        return;
+    }
+
+    mapRows();
+    if (from < to)
+    {
+        std::rotate(m_rowRecords.begin() + from, m_rowRecords.begin() + from + count, m_rowRecords.begin() + to + count);
+        updateRecordRows(from, to + count - 1);
+    }
+    else
+    {
+        std::rotate(m_rowRecords.begin() + to, m_rowRecords.begin() + from, m_rowRecords.begin() + from + count);
+        updateRecordRows(to, from + count - 1);
+    }
+}
+
+// Mirrors SampleItem::tick, skipping pages without stepping records
+void SamplePagedStore::tick(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    // Once rows are mapped any record page may hold rows of the range
+    const int firstPage = m_mapped ? 0 : first / PageRows;
+    const int lastPage = m_mapped ? static_cast<int>(m_steppingRecords.size()) - 1 : last / PageRows;
+    for (int pageIndex = firstPage; pageIndex <= lastPage; ++pageIndex)
+    {
+        if (m_steppingRecords[pageIndex] == 0)
+        {
+            continue;
+        }
+
+        Page& cached = page(pageIndex);
+        const int pageFirst = pageIndex * PageRows;
+        const int pageRecords = std::min(static_cast<int>(cached.records.size()), m_recordCount - pageFirst);
+        for (int i = 0; i < pageRecords; ++i)
+        {
+            const int row = m_mapped ? m_recordRows[pageFirst + i] : pageFirst + i;
+            Record& stepped = cached.records[i];
+            if (row >= first && row <= last && stepped.state == SampleItem::STEPPING)
+            {
+                int changes = SampleItem::StepChange;
+                const int step = stepped.step;
+                stepped.step += std::max<int>(stepped.stepRate, 1);
+                if (stepped.step >= stepped.maxSteps)
+                {
+                    stepped.step = stepped.maxSteps;
+                    stepped.state = SampleItem::COMPLETE;
+                    --m_steppingRecords[pageIndex];
+                    changes |= SampleItem::StateChange;
+                }
+                m_stats.changeRow(SampleItem::STEPPING, step, stepped.maxSteps,
+                    static_cast<SampleItem::State>(stepped.state), stepped.step, stepped.maxSteps);
+                cached.dirty = true;
+                dirtyRows.mark(row, changes);
+            }
+        }
+    }
+}
+
+//===========================================================================================================
+// Pages
+//===========================================================================================================
+
+SamplePagedStore::Record SamplePagedStore::makeRecord(quint32 id, const QString& name)
+{
+    Record result;
+    std::memset(&result, 0, sizeof(result));
+    result.id = id;
+    result.state = SampleItem::NONE;
+    result.maxSteps = SampleItem::DefaultMaxSteps;
+    result.stepRate = 1;
+    writeName(result, name);
+    return result;
+}
+
+// Names longer than the record holds are cut at a character boundary
+void SamplePagedStore::writeName(Record& record, const QString& name)
+{
+    QByteArray utf8 = name.toUtf8();
+    if (utf8.size() > NameCapacity)
+    {
+        int size = NameCapacity;
+        while (size > 0 && (static_cast<quint8>(utf8[size]) & 0xC0) == 0x80)
+        {
+            --size;
+        }
+        utf8.truncate(size);
+    }
+    std::memset(record.name, 0, NameCapacity);
+    std::memcpy(record.name, utf8.constData(), utf8.size());
+    record.nameSize = static_cast<quint8>(utf8.size());
+}
+
+qint64 SamplePagedStore::recordOffset(int index)
+{
+    return static_cast<qint64>(sizeof(Header)) + static_cast<qint64>(index) * sizeof(Record);
+}
+
+bool SamplePagedStore::writeHeader(QFileDevice& file, int count, quint32 nextId)
+{
+    const Header header = { DatasetMagic, DatasetVersion, sizeof(Record), static_cast<quint32>(count), nextId };
+    return file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+}
+
+bool SamplePagedStore::writeRecords(QFileDevice& file, const Record* records, int count)
+{
+    const qint64 size = static_cast<qint64>(count * sizeof(Record));
+    return file.write(reinterpret_cast<const char*>(records), size) == size;
+}
+
+// Returns the bytes read, which is short of the records asked for past the end of the file
+qint64 SamplePagedStore::readRecords(QFile& file, int first, Record* records, int count)
+{
+    if (!file.isOpen() || !file.seek(recordOffset(first)))
+    {
+        return 0;
+    }
+    return std::max<qint64>(file.read(reinterpret_cast<char*>(records), static_cast<qint64>(count * sizeof(Record))), 0);
+}
+
+int SamplePagedStore::recordIndex(int row) const
+{
+    return m_mapped ? m_rowRecords[row] : row;
+}
+
+const SamplePagedStore::Record& SamplePagedStore::record(int row) const
+{
+    return recordAt(recordIndex(row));
+}
+
+SamplePagedStore::Record& SamplePagedStore::writableRecord(int row)
+{
+    return writableRecordAt(recordIndex(row));
+}
+
+const SamplePagedStore::Record& SamplePagedStore::recordAt(int index) const
+{
+    return page(index / PageRows).records[index % PageRows];
+}
+
+SamplePagedStore::Record& SamplePagedStore::writableRecordAt(int index)
+{
+    Page& cached = page(index / PageRows);
+    cached.dirty = true;
+    return cached.records[index % PageRows];
+}
+
+// Returns the page, loading it and evicting the least recently used page if needed
+// A page is read from the scratch file once it has been written there, and from the dataset before that
+SamplePagedStore::Page& SamplePagedStore::page(int index) const
+{
+    const int rows = std::min(PageRows, m_recordCount - index * PageRows);
+    auto found = m_pageIndex.constFind(index);
+    if (found != m_pageIndex.constEnd())
+    {
+        const PageList::iterator cached = found.value();
+        if (cached != m_pages.begin())
+        {
+            m_pages.splice(m_pages.begin(), m_pages, cached);
+        }
+        if (static_cast<int>(cached->records.size()) < rows)
+        {
+            cached->records.resize(rows);
+        }
+        return *cached;
+    }
+
+    m_pages.push_front({ index, false, std::vector<Record>(rows) });
+    Page& loaded = m_pages.front();
+    const int first = index * PageRows;
+    qint64 read = 0;
+    if (index < static_cast<int>(m_scratchPages.size()) && m_scratchPages[index])
+    {
+        read = readRecords(m_scratch, first, loaded.records.data(), rows);
+    }
+    else if (first < m_datasetRecords)
+    {
+        read = readRecords(m_dataset, first, loaded.records.data(), std::min(rows, m_datasetRecords - first));
+    }
+
+    const qint64 size = static_cast<qint64>(rows * sizeof(Record));
+    if (read < size)
+    {
+        // Records appended since the page was last written are not on disk yet
+        std::memset(reinterpret_cast<char*>(loaded.records.data()) + read, 0, static_cast<size_t>(size - read));
+    }
+    m_pageIndex.insert(index, m_pages.begin());
+    evictPages();
+    return loaded;
+}
+
+bool SamplePagedStore::writePage(const Page& page) const
+{
+    const int rows = std::min(static_cast<int>(page.records.size()), m_recordCount - page.index * PageRows);
+    if (rows <= 0)
+    {
+        return true;
+    }
+    if (!m_scratch.isOpen() || !m_scratch.seek(recordOffset(page.index * PageRows)) ||
+        !writeRecords(m_scratch, page.records.data(), rows))
+    {
+        return false;
+    }
+
+    if (static_cast<int>(m_scratchPages.size()) <= page.index)
+    {
+        m_scratchPages.resize(page.index + 1, false);
+    }
+    m_scratchPages[page.index] = true;
+    return true;
+}
+
+// The front page was just used, so it is never the one evicted
+void SamplePagedStore::evictPages() const
+{
+    while (static_cast<int>(m_pages.size()) > m_pageCapacity)
+    {
+        const Page& evicted = m_pages.back();
+        if (evicted.dirty && !writePage(evicted))
+        {
+            // Keeping the page costs memory but loses no rows, the next eviction retries it
+            qWarning("Failed to write page %d to the scratch file: %s", evicted.index, qPrintable(m_scratch.errorString()));
+            return;
+        }
+        m_pageIndex.remove(evicted.index);
+        m_pages.pop_back();
+    }
+}
+
+void SamplePagedStore::resetPages()
+{
+    m_pages.clear();
+    m_pageIndex.clear();
+}
+
+// Rows start out as the records in file order
+void SamplePagedStore::mapRows()
+{
+    if (m_mapped)
+    {
+        return;
+    }
+
+    m_rowRecords.resize(m_count);
+    std::iota(m_rowRecords.begin(), m_rowRecords.end(), 0);
+    m_recordRows = m_rowRecords;
+    m_mapped = true;
+}
+
+void SamplePagedStore::updateRecordRows(int first, int last)
+{
+    for (int row = first; row <= last; ++row)
+    {
+        m_recordRows[m_rowRecords[row]] = row;
+    }
+}
+
+void SamplePagedStore::countState(int index, quint8 state, int delta)
+{
+    if (state == SampleItem::STEPPING)
+    {
+        m_steppingRecords[index / PageRows] += delta;
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "sampleStore.h"
+#include <qfile.h>
+#include <qtemporaryfile.h>
+#include <qhash.h>
+#include <list>
+#include <vector>
+#include <cstdint>
+
+/**
+* Stores the rows in a dataset file and keeps a bounded number of pages in memory
+* Pages are loaded on first access and the least recently used page is dropped once the
+* limit is reached, so memory stays flat whatever the row count
+* The dataset is only read, changed pages are written to a scratch file and reach a dataset
+* only through save
+* Rows are the records in file order until the first remove or move, which builds an index
+* of 8 bytes per row, removed records are then left as holes that append reuses and save drops
+* Only pages holding stepping records are visited by tick, their counts are kept per page
+*/
+class SamplePagedStore : public SampleStore
+{
+public:
+    static const int PageRows = 1024;
+    static const int DefaultPageCapacity = 64;
+    static const int NameCapacity = 48;
+
+    SamplePagedStore();
+    virtual ~SamplePagedStore();
+
+    /**
+    * Opens an existing dataset for reading, the store is left empty if the file is not a valid dataset
+    */
+    bool open(const QString& path);
+    void close();
+
+    /**
+    * Writes the rows in order to a dataset and continues from it
+    * Saving over the opened dataset is the only way it is changed
+    */
+    bool save(const QString& path);
+
+    /**
+    * Writes a dataset of count idle rows without holding them in memory
+    */
+    static bool createDataset(const QString& path, int count, const QString& namePrefix);
+
+    void setPageCapacity(int pages);
+    int pageCapacity() const;
+    int residentPages() const;
+
+    virtual int count() const override;
+    virtual QString name(int row) const override;
+    virtual SampleItem::State state(int row) const override;
+    virtual int step(int row) const override;
+    virtual int maxSteps(int row) const override;
+    virtual int stepRate(int row) const override;
+    virtual quint32 id(int row) const override;
+
+    virtual void setName(int row, const QString& name) override;
+    virtual void setState(int row, SampleItem::State state) override;
+    virtual void setStep(int row, int step) override;
+    virtual void setMaxSteps(int row, int maxSteps) override;
+    virtual void setStepRate(int row, int stepRate) override;
+
+    virtual void reserve(int count) override;
+    virtual void append(const QString& name) override;
+    virtual void remove(int row, int count) override;
+    virtual void move(int from, int count, int to) override;
+
+    virtual void tick(int first, int last, SampleDirtyTracker& dirtyRows) override;
+
+private:
+    /**
+    * On disk layout of a row, written in native byte order
+    * A step rate of 0 is read as 1, datasets written before it existed hold 0 there
+    */
+    struct Record
+    {
+        quint32 id;
+        quint8 state;
+        quint8 nameSize;
+        quint16 stepRate;
+        qint32 step;
+        qint32 maxSteps;
+        char name[NameCapacity];
+    };
+
+    struct Header
+    {
+        quint32 magic;
+        quint16 version;
+        quint16 recordSize;
+        quint32 rowCount;
+        quint32 nextId;
+    };
+
+    struct Page
+    {
+        int index;
+        bool dirty;
+        std::vector<Record> records;
+    };
+
+    typedef std::list<Page> PageList;
+
+    static Record makeRecord(quint32 id, const QString& name);
+    static void writeName(Record& record, const QString& name);
+    static qint64 recordOffset(int index);
+    static bool writeHeader(QFileDevice& file, int count, quint32 nextId);
+    static bool writeRecords(QFileDevice& file, const Record* records, int count);
+    static qint64 readRecords(QFile& file, int first, Record* records, int count);
+
+    int recordIndex(int row) const;
+    const Record& record(int row) const;
+    Record& writableRecord(int row);
+    const Record& recordAt(int index) const;
+    Record& writableRecordAt(int index);
+    Page& page(int index) const;
+    bool writePage(const Page& page) const;
+    void evictPages() const;
+    void resetPages();
+
+    void mapRows();
+    void updateRecordRows(int first, int last);
+    void countState(int index, quint8 state, int delta);
+
+    mutable QFile m_dataset;
+    mutable QTemporaryFile m_scratch;
+    int m_count = 0;
+    int m_recordCount = 0;
+    int m_datasetRecords = 0;
+    quint32 m_nextId = 0;
+    int m_pageCapacity = DefaultPageCapacity;
+
+    // Pages are ordered from most to least recently used
+    mutable PageList m_pages;
+    mutable QHash<int, PageList::iterator> m_pageIndex;
+    mutable std::vector<bool> m_scratchPages;
+    std::vector<int> m_steppingRecords;
+
+    // Built by mapRows, a removed record maps back to row -1 until append reuses it
+    bool m_mapped = false;
+    std::vector<int> m_rowRecords;
+    std::vector<int> m_recordRows;
+    std::vector<int> m_freeRecords;
+};
@@ -0,0 +1,590 @@
+#include "sampleProgressList.h"
+#include "sampleModel.h"
+#include "sampleTrace.h"
+#include <qquickwindow.h>
+#include <qsgnode.h>
+#include <qsggeometry.h>
+#include <qsgvertexcolormaterial.h>
+#include <qsgsimpletexturenode.h>
+#include <qimage.h>
+#include <qpainter.h>
+#include <qevent.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int QuadVertices = 6;
+
+    // Qt 6 replaced localPos and posF with position
+    QPointF eventPosition(const QMouseEvent* event)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return event->position();
+#else
+        return eventPosition(event);
+#endif
+    }
+
+    QPointF eventPosition(const QHoverEvent* event)
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        return event->position();
+#else
+        return eventPosition(event);
+#endif
+    }
+
+    // The vertex color material expects premultiplied colors
+    void writeRect(QSGGeometry::ColoredPoint2D*& vertex, qreal left, qreal top, qreal right, qreal bottom,
+        const QColor& color, qreal clipBottom)
+    {
+        top = std::max<qreal>(top, 0.0);
+        bottom = std::min(bottom, clipBottom);
+        if (bottom < top)
+        {
+            bottom = top;
+        }
+
+        const int alpha = color.alpha();
+        const auto r = static_cast<uchar>(color.red() * alpha / 255);
+        const auto g = static_cast<uchar>(color.green() * alpha / 255);
+        const auto b = static_cast<uchar>(color.blue() * alpha / 255);
+        const auto a = static_cast<uchar>(alpha);
+        const float x0 = static_cast<float>(left);
+        const float y0 = static_cast<float>(top);
+        const float x1 = static_cast<float>(right);
+        const float y1 = static_cast<float>(bottom);
+        (vertex++)->set(x0, y0, r, g, b, a);
+        (vertex++)->set(x1, y0, r, g, b, a);
+        (vertex++)->set(x0, y1, r, g, b, a);
+        (vertex++)->set(x1, y0, r, g, b, a);
+        (vertex++)->set(x1, y1, r, g, b, a);
+        (vertex++)->set(x0, y1, r, g, b, a);
+    }
+}
+
+SampleProgressList::SampleProgressList(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+    setAcceptedMouseButtons(Qt::LeftButton | Qt::RightButton);
+    setAcceptHoverEvents(true);
+    m_font.setPointSize(8);
+
+    m_pressAndHoldTimer.setSingleShot(true);
+    m_pressAndHoldTimer.setInterval(PressAndHoldMs);
+    connect(&m_pressAndHoldTimer, &QTimer::timeout, this, &SampleProgressList::onPressAndHold);
+    connect(this, &SampleProgressList::colorsChanged, this, &QQuickItem::update);
+    connect(this, &SampleProgressList::labelStyleChanged, this, &SampleProgressList::invalidateLabels);
+}
+
+SampleProgressList::~SampleProgressList() = default;
+
+//===========================================================================================================
+// Properties
+//===========================================================================================================
+
+SampleModel* SampleProgressList::model() const
+{
+    return m_model;
+}
+
+void SampleProgressList::setModel(SampleModel* model)
+{
+    if (m_model == model)
+    {
+        return;
+    }
+
+    for (const auto& connection : m_modelConnections)
+    {
+        disconnect(connection);
+    }
+    m_modelConnections.clear();
+    m_model = model;
+
+    if (model)
+    {
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::dataChanged, this, &SampleProgressList::onDataChanged));
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::rowsInserted, this, &SampleProgressList::onRowsChanged));
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::rowsRemoved, this, &SampleProgressList::onRowsChanged));
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::rowsMoved, this, &SampleProgressList::onRowsChanged));
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::modelReset, this, &SampleProgressList::onRowsChanged));
+        m_modelConnections.push_back(connect(model, &QAbstractItemModel::layoutChanged, this, &SampleProgressList::onRowsChanged));
+    }
+    emit modelChanged();
+    onRowsChanged();
+}
+
+int SampleProgressList::rowHeight() const
+{
+    return m_rowHeight;
+}
+
+void SampleProgressList::setRowHeight(int rowHeight)
+{
+    rowHeight = std::max(rowHeight, 1);
+    if (m_rowHeight != rowHeight)
+    {
+        m_rowHeight = rowHeight;
+        emit rowHeightChanged();
+        onRowsChanged();
+    }
+}
+
+qreal SampleProgressList::contentY() const
+{
+    return m_contentY;
+}
+
+void SampleProgressList::setContentY(qreal contentY)
+{
+    contentY = std::max<qreal>(0.0, std::min(contentY, contentHeight() - height()));
+    if (m_contentY != contentY)
+    {
+        m_contentY = contentY;
+        emit contentYChanged();
+        fetchVisibleRows();
+        polish();
+        update();
+    }
+}
+
+qreal SampleProgressList::contentHeight() const
+{
+    return static_cast<qreal>(rowCount()) * m_rowHeight;
+}
+
+int SampleProgressList::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+void SampleProgressList::setCurrentIndex(int row)
+{
+    if (m_currentIndex != row)
+    {
+        m_currentIndex = row;
+        emit currentIndexChanged();
+        emit currentStateChanged();
+        update();
+    }
+}
+
+int SampleProgressList::currentState() const
+{
+    return m_currentIndex >= 0 && m_currentIndex < rowCount() ? m_model->store().state(m_currentIndex) : -1;
+}
+
+int SampleProgressList::hoveredIndex() const
+{
+    return m_hoveredIndex;
+}
+
+void SampleProgressList::setHoveredIndex(int row)
+{
+    if (m_hoveredIndex != row)
+    {
+        m_hoveredIndex = row;
+        emit hoveredIndexChanged();
+        update();
+    }
+}
+
+bool SampleProgressList::isDragging() const
+{
+    return m_dragging;
+}
+
+void SampleProgressList::setDragging(bool dragging)
+{
+    if (m_dragging != dragging)
+    {
+        m_dragging = dragging;
+        emit draggingChanged();
+        update();
+    }
+}
+
+int SampleProgressList::rowAt(qreal y) const
+{
+    if (y < 0.0 || y >= height())
+    {
+        return -1;
+    }
+    const int row = static_cast<int>(std::floor((y + m_contentY) / m_rowHeight));
+    return row < rowCount() ? row : -1;
+}
+
+void SampleProgressList::positionViewAtRow(int row)
+{
+    const qreal top = static_cast<qreal>(row) * m_rowHeight;
+    if (top < m_contentY)
+    {
+        setContentY(top);
+    }
+    else if (top + m_rowHeight > m_contentY + height())
+    {
+        setContentY(top + m_rowHeight - height());
+    }
+}
+
+void SampleProgressList::positionViewAtEnd()
+{
+    setContentY(contentHeight() - height());
+}
+
+//===========================================================================================================
+// Model
+//===========================================================================================================
+
+// Steps only move the bars, the label texture is kept unless a name or state of its rows changed
+void SampleProgressList::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    const bool stateChanged = roles.isEmpty() || roles.contains(SampleModel::StateValueRole);
+    if (stateChanged && m_currentIndex >= topLeft.row() && m_currentIndex <= bottomRight.row())
+    {
+        emit currentStateChanged();
+    }
+
+    const bool labelsChanged = roles.isEmpty() || roles.contains(SampleModel::NameRole) || roles.contains(SampleModel::StateDescRole);
+    if (labelsChanged && bottomRight.row() >= m_labelFirstRow && topLeft.row() < m_labelFirstRow + m_labelRows)
+    {
+        m_labelsDirty = true;
+        polish();
+    }
+
+    if (bottomRight.row() >= firstVisibleRow() && topLeft.row() <= lastVisibleRow())
+    {
+        update();
+    }
+}
+
+void SampleProgressList::onRowsChanged()
+{
+    emit contentHeightChanged();
+    setContentY(m_contentY);
+    if (m_currentIndex >= rowCount())
+    {
+        setCurrentIndex(rowCount() - 1);
+    }
+    emit currentStateChanged();
+    fetchVisibleRows();
+    invalidateLabels();
+}
+
+// Paged models hand out rows as views scroll towards their end
+void SampleProgressList::fetchVisibleRows()
+{
+    const QModelIndex root;
+    if (m_model && lastVisibleRow() >= rowCount() - 1 && m_model->canFetchMore(root))
+    {
+        m_model->fetchMore(root);
+    }
+}
+
+void SampleProgressList::invalidateLabels()
+{
+    m_labelsDirty = true;
+    polish();
+    update();
+}
+
+int SampleProgressList::rowCount() const
+{
+    return m_model ? m_model->rowCount() : 0;
+}
+
+int SampleProgressList::firstVisibleRow() const
+{
+    return static_cast<int>(m_contentY / m_rowHeight);
+}
+
+int SampleProgressList::lastVisibleRow() const
+{
+    const int last = static_cast<int>(std::ceil((m_contentY + height()) / m_rowHeight)) - 1;
+    return std::min(last, rowCount() - 1);
+}
+
+// The dragged row is dropped in front of the row under its center
+int SampleProgressList::dropRow() const
+{
+    const int row = static_cast<int>(std::floor((m_dragY + m_contentY) / m_rowHeight));
+    return std::max(0, std::min(row, rowCount() - 1));
+}
+
+//===========================================================================================================
+// Input
+//===========================================================================================================
+
+void SampleProgressList::mousePressEvent(QMouseEvent* event)
+{
+    const int row = rowAt(eventPosition(event).y());
+    m_pressedRow = row;
+    m_dragY = eventPosition(event).y();
+    if (row >= 0)
+    {
+        setCurrentIndex(row);
+        if (event->button() == Qt::LeftButton)
+        {
+            m_pressAndHoldTimer.start();
+        }
+    }
+    event->accept();
+}
+
+void SampleProgressList::mouseMoveEvent(QMouseEvent* event)
+{
+    if (m_dragging)
+    {
+        m_dragY = std::max<qreal>(0.0, std::min(eventPosition(event).y(), height() - 1.0));
+        update();
+    }
+    setHoveredIndex(rowAt(eventPosition(event).y()));
+}
+
+void SampleProgressList::mouseReleaseEvent(QMouseEvent* event)
+{
+    m_pressAndHoldTimer.stop();
+    const int row = rowAt(eventPosition(event).y());
+    if (m_dragging)
+    {
+        const int to = dropRow();
+        setDragging(false);
+        if (m_model && m_pressedRow >= 0 && to != m_pressedRow)
+        {
+            m_model->moveItems(m_pressedRow, to);
+            setCurrentIndex(to);
+        }
+    }
+    else if (row >= 0)
+    {
+        emit clicked(row);
+        if (event->button() == Qt::RightButton)
+        {
+            emit contextMenuRequested(row, eventPosition(event).x(), eventPosition(event).y());
+        }
+    }
+    m_pressedRow = -1;
+}
+
+void SampleProgressList::mouseUngrabEvent()
+{
+    m_pressAndHoldTimer.stop();
+    m_pressedRow = -1;
+    setDragging(false);
+}
+
+void SampleProgressList::onPressAndHold()
+{
+    if (m_pressedRow >= 0)
+    {
+        setDragging(true);
+    }
+}
+
+void SampleProgressList::hoverMoveEvent(QHoverEvent* event)
+{
+    setHoveredIndex(rowAt(eventPosition(event).y()));
+}
+
+void SampleProgressList::hoverLeaveEvent(QHoverEvent* event)
+{
+    Q_UNUSED(event);
+    setHoveredIndex(-1);
+}
+
+// Scrolls three rows per wheel step
+void SampleProgressList::wheelEvent(QWheelEvent* event)
+{
+    setContentY(m_contentY - event->angleDelta().y() / 120.0 * m_rowHeight * 3);
+    setHoveredIndex(rowAt(event->position().y()));
+    event->accept();
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+void SampleProgressList::geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    onGeometryChanged();
+}
+#else
+void SampleProgressList::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    onGeometryChanged();
+}
+#endif
+
+void SampleProgressList::onGeometryChanged()
+{
+    setContentY(m_contentY);
+    fetchVisibleRows();
+    invalidateLabels();
+}
+
+//===========================================================================================================
+// Rendering
+//===========================================================================================================
+
+// Runs on the gui thread before the frame is synchronized, so the text is never laid out on the render thread
+// The strip holds the visible rows and half a view of rows above and below them
+void SampleProgressList::updatePolish()
+{
+    const int first = firstVisibleRow();
+    const int last = lastVisibleRow();
+    if (!window() || (!m_labelsDirty && labelsCover(first, last)))
+    {
+        return;
+    }
+
+    SAMPLE_TRACE_SCOPE("model", "progressListLabels");
+    m_labelsDirty = false;
+    const int viewRows = static_cast<int>(std::ceil(height() / m_rowHeight)) + 1;
+    m_labelFirstRow = std::max(0, first - viewRows / 2);
+    m_labelRows = viewRows * 2;
+    m_labelRatio = window()->effectiveDevicePixelRatio();
+    m_labelImage = drawLabels(m_labelFirstRow, m_labelRows, m_labelRatio);
+    m_labelImageChanged = true;
+    update();
+}
+
+// Runs on the render thread while the gui thread is blocked, so the store and the label image are read directly
+QSGNode* SampleProgressList::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data)
+{
+    Q_UNUSED(data);
+    SAMPLE_TRACE_SCOPE("scenegraph", "progressList");
+
+    QSGNode* root = oldNode;
+    QSGGeometryNode* bars = nullptr;
+    QSGSimpleTextureNode* labels = nullptr;
+    if (!root)
+    {
+        root = new QSGNode();
+
+        bars = new QSGGeometryNode();
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        bars->setGeometry(geometry);
+        bars->setFlag(QSGNode::OwnsGeometry);
+        bars->setMaterial(new QSGVertexColorMaterial());
+        bars->setFlag(QSGNode::OwnsMaterial);
+        root->appendChildNode(bars);
+
+        labels = new QSGSimpleTextureNode();
+        labels->setOwnsTexture(true);
+        root->appendChildNode(labels);
+    }
+    else
+    {
+        bars = static_cast<QSGGeometryNode*>(root->firstChild());
+        labels = static_cast<QSGSimpleTextureNode*>(root->lastChild());
+    }
+
+    writeGeometry(bars->geometry());
+    bars->markDirty(QSGNode::DirtyGeometry);
+
+    if ((m_labelImageChanged || !labels->texture()) && !m_labelImage.isNull() && window())
+    {
+        labels->setTexture(window()->createTextureFromImage(m_labelImage));
+        m_labelImageChanged = false;
+    }
+
+    if (labels->texture())
+    {
+        const qreal stripY = m_contentY - static_cast<qreal>(m_labelFirstRow) * m_rowHeight;
+        labels->setRect(QRectF(0.0, 0.0, width(), height()));
+        labels->setSourceRect(QRectF(0.0, stripY * m_labelRatio, width() * m_labelRatio, height() * m_labelRatio));
+    }
+    return root;
+}
+
+bool SampleProgressList::labelsCover(int first, int last) const
+{
+    return first >= m_labelFirstRow && last < m_labelFirstRow + m_labelRows;
+}
+
+// Three quads per visible row, background, track and bar, plus the dragged row and drop marker
+void SampleProgressList::writeGeometry(QSGGeometry* geometry) const
+{
+    const int first = firstVisibleRow();
+    const int last = lastVisibleRow();
+    const int rows = std::max(0, last - first + 1);
+    const int quads = m_model ? rows * 3 + (m_dragging ? 2 : 0) : 0;
+    geometry->allocate(quads * QuadVertices);
+    if (quads == 0)
+    {
+        return;
+    }
+
+    const SampleStore& store = m_model->store();
+    const qreal right = width();
+    const qreal bottom = height();
+    const qreal barLeft = right - Margin - BarWidth;
+    auto* vertex = geometry->vertexDataAsColoredPoint2D();
+    for (int row = first; row <= last; ++row)
+    {
+        const qreal top = static_cast<qreal>(row) * m_rowHeight - m_contentY;
+        const QColor& background = row == m_currentIndex ? m_selectedColor
+            : row == m_hoveredIndex ? m_hoverColor
+            : (row & 1) ? m_rowColor : m_alternateRowColor;
+        writeRect(vertex, 0.0, top, right, top + m_rowHeight, background, bottom);
+
+        const qreal barTop = top + (m_rowHeight - BarHeight) / 2.0;
+        const int maxSteps = std::max(store.maxSteps(row), 1);
+        const qreal progress = std::max(0, std::min(store.step(row), maxSteps)) / static_cast<qreal>(maxSteps);
+        writeRect(vertex, barLeft, barTop, barLeft + BarWidth, barTop + BarHeight, m_trackColor, bottom);
+        writeRect(vertex, barLeft, barTop, barLeft + BarWidth * progress, barTop + BarHeight, m_barColor, bottom);
+    }
+
+    if (m_dragging)
+    {
+        const qreal dropTop = static_cast<qreal>(dropRow()) * m_rowHeight - m_contentY;
+        writeRect(vertex, 0.0, dropTop - 1.0, right, dropTop + 1.0, m_dragColor, bottom);
+
+        QColor dragged = m_dragColor;
+        dragged.setAlpha(96);
+        const qreal dragTop = m_dragY - m_rowHeight / 2.0;
+        writeRect(vertex, 0.0, dragTop, right, dragTop + m_rowHeight, dragged, bottom);
+    }
+}
+
+// Names on the left and states in front of the bars, drawn once for all rows of the strip
+QImage SampleProgressList::drawLabels(int first, int rows, qreal ratio) const
+{
+    const qreal stripHeight = static_cast<qreal>(rows) * m_rowHeight;
+    const QSize size(static_cast<int>(std::ceil(width() * ratio)), static_cast<int>(std::ceil(stripHeight * ratio)));
+    if (size.isEmpty())
+    {
+        return QImage();
+    }
+
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+    if (!m_model)
+    {
+        return image;
+    }
+
+    const SampleStore& store = m_model->store();
+    QFont nameFont = m_font;
+    nameFont.setBold(true);
+    const qreal stateLeft = width() - Margin - BarWidth - Margin - StateWidth;
+
+    QPainter painter(&image);
+    painter.setPen(m_textColor);
+    const int last = std::min(first + rows, rowCount()) - 1;
+    for (int row = first; row <= last; ++row)
+    {
+        const qreal top = static_cast<qreal>(row - first) * m_rowHeight;
+        painter.setFont(nameFont);
+        painter.drawText(QRectF(Margin, top, std::max<qreal>(stateLeft - Margin * 2, 0.0), m_rowHeight),
+            Qt::AlignLeft | Qt::AlignVCenter, store.name(row));
+        painter.setFont(m_font);
+        painter.drawText(QRectF(stateLeft, top, StateWidth, m_rowHeight),
+            Qt::AlignRight | Qt::AlignVCenter, SampleItem::stateToString(store.state(row)));
+    }
+    return image;
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <qquickitem.h>
+#include <qpointer.h>
+#include <qcolor.h>
+#include <qfont.h>
+#include <qtimer.h>
+#include <qimage.h>
+#include <vector>
+
+class SampleModel;
+class QSGGeometry;
+
+/**
+* Draws the rows of a SampleModel straight from its store without a delegate per row
+* Row backgrounds and progress bars of the visible rows are batched into one geometry
+* node sharing a single vertex color material, names and states are drawn into one
+* texture covering a strip of rows around the visible ones, scrolling within the strip
+* only moves the part of the texture shown, it is redrawn when names or states of its
+* rows change or the visible rows leave it
+* The strip is drawn on the gui thread while polishing, the render thread only uploads it
+* Rows are hit tested by position for selection, dragging and the context menu
+*/
+class SampleProgressList : public QQuickItem
+{
+    Q_OBJECT
+
+    Q_PROPERTY(SampleModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(int rowHeight READ rowHeight WRITE setRowHeight NOTIFY rowHeightChanged)
+    Q_PROPERTY(qreal contentY READ contentY WRITE setContentY NOTIFY contentYChanged)
+    Q_PROPERTY(qreal contentHeight READ contentHeight NOTIFY contentHeightChanged)
+    Q_PROPERTY(int currentIndex READ currentIndex WRITE setCurrentIndex NOTIFY currentIndexChanged)
+    Q_PROPERTY(int currentState READ currentState NOTIFY currentStateChanged)
+    Q_PROPERTY(int hoveredIndex READ hoveredIndex NOTIFY hoveredIndexChanged)
+    Q_PROPERTY(bool dragging READ isDragging NOTIFY draggingChanged)
+    Q_PROPERTY(QFont font MEMBER m_font NOTIFY labelStyleChanged)
+    Q_PROPERTY(QColor textColor MEMBER m_textColor NOTIFY labelStyleChanged)
+    Q_PROPERTY(QColor rowColor MEMBER m_rowColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor alternateRowColor MEMBER m_alternateRowColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor hoverColor MEMBER m_hoverColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor selectedColor MEMBER m_selectedColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor dragColor MEMBER m_dragColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor trackColor MEMBER m_trackColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor barColor MEMBER m_barColor NOTIFY colorsChanged)
+
+public:
+    static const int PressAndHoldMs = 250;
+    static const int BarWidth = 100;
+    static const int BarHeight = 8;
+    static const int StateWidth = 80;
+    static const int Margin = 4;
+
+    SampleProgressList(QQuickItem* parent = nullptr);
+    virtual ~SampleProgressList();
+
+    SampleModel* model() const;
+    void setModel(SampleModel* model);
+    int rowHeight() const;
+    void setRowHeight(int rowHeight);
+    qreal contentY() const;
+    void setContentY(qreal contentY);
+    qreal contentHeight() const;
+    int currentIndex() const;
+    void setCurrentIndex(int row);
+
+    /**
+    * SampleItem::State of the current row, -1 without one
+    */
+    int currentState() const;
+    int hoveredIndex() const;
+    bool isDragging() const;
+
+    /**
+    * Row under y in item coordinates, -1 if there is none
+    */
+    Q_INVOKABLE int rowAt(qreal y) const;
+    Q_INVOKABLE void positionViewAtRow(int row);
+    Q_INVOKABLE void positionViewAtEnd();
+
+signals:
+    void modelChanged();
+    void rowHeightChanged();
+    void contentYChanged();
+    void contentHeightChanged();
+    void currentIndexChanged();
+    void currentStateChanged();
+    void hoveredIndexChanged();
+    void draggingChanged();
+    void labelStyleChanged();
+    void colorsChanged();
+    void clicked(int row);
+    void contextMenuRequested(int row, qreal x, qreal y);
+
+protected:
+    virtual void updatePolish() override;
+    virtual QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    virtual void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+#else
+    virtual void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+#endif
+    virtual void mousePressEvent(QMouseEvent* event) override;
+    virtual void mouseMoveEvent(QMouseEvent* event) override;
+    virtual void mouseReleaseEvent(QMouseEvent* event) override;
+    virtual void mouseUngrabEvent() override;
+    virtual void hoverMoveEvent(QHoverEvent* event) override;
+    virtual void hoverLeaveEvent(QHoverEvent* event) override;
+    virtual void wheelEvent(QWheelEvent* event) override;
+
+private:
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onRowsChanged();
+    void onPressAndHold();
+    void setHoveredIndex(int row);
+    void setDragging(bool dragging);
+    void onGeometryChanged();
+    void invalidateLabels();
+    void fetchVisibleRows();
+    int rowCount() const;
+    int firstVisibleRow() const;
+    int lastVisibleRow() const;
+    int dropRow() const;
+
+    void writeGeometry(QSGGeometry* geometry) const;
+    bool labelsCover(int first, int last) const;
+    QImage drawLabels(int first, int rows, qreal ratio) const;
+
+    QPointer<SampleModel> m_model;
+    std::vector<QMetaObject::Connection> m_modelConnections;
+    int m_rowHeight = 25;
+    qreal m_contentY = 0.0;
+    int m_currentIndex = -1;
+    int m_hoveredIndex = -1;
+    bool m_labelsDirty = true;
+
+    // Rows drawn into the label strip and its device pixel ratio, the image is kept
+    // after uploading it so a node created again after the scene graph is lost can use it
+    int m_labelFirstRow = 0;
+    int m_labelRows = 0;
+    qreal m_labelRatio = 1.0;
+    QImage m_labelImage;
+    bool m_labelImageChanged = false;
+
+    // Press and hold on a row starts dragging it, it is dropped in front of the row under it
+    QTimer m_pressAndHoldTimer;
+    int m_pressedRow = -1;
+    bool m_dragging = false;
+    qreal m_dragY = 0.0;
+
+    QFont m_font;
+    QColor m_textColor = Qt::black;
+    QColor m_rowColor = Qt::white;
+    QColor m_alternateRowColor = QColor("#F5F5F5");
+    QColor m_hoverColor = QColor("#E0E8FF");
+    QColor m_selectedColor = QColor("#8EACFF");
+    QColor m_dragColor = Qt::red;
+    QColor m_trackColor = QColor("#DDDDDD");
+    QColor m_barColor = QColor("#3A7BD5");
+};
@@ -0,0 +1,85 @@
+#include "sampleRoleCache.h"
+
+SampleRoleCache::SampleRoleCache(int firstRole, int roleCount)
+    : m_firstRole(firstRole)
+    , m_roleCount(roleCount)
+    , m_slots(SlotCount)
+    , m_values(static_cast<size_t>(SlotCount) * roleCount)
+{
+}
+
+const QVariant* SampleRoleCache::find(int row, int role) const
+{
+    const quint32 bit = roleBit(role);
+    const int slot = slotIndex(row);
+    if (bit && m_slots[slot].row == row && (m_slots[slot].validRoles & bit))
+    {
+        return &m_values[static_cast<size_t>(slot) * m_roleCount + (role - m_firstRole)];
+    }
+    return nullptr;
+}
+
+// A row taking over a slot evicts whatever row held it before
+void SampleRoleCache::insert(int row, int role, const QVariant& value)
+{
+    const quint32 bit = roleBit(role);
+    if (!bit || row < 0)
+    {
+        return;
+    }
+
+    const int slot = slotIndex(row);
+    if (m_slots[slot].row != row)
+    {
+        m_slots[slot].row = row;
+        m_slots[slot].validRoles = 0;
+    }
+    m_slots[slot].validRoles |= bit;
+    m_values[static_cast<size_t>(slot) * m_roleCount + (role - m_firstRole)] = value;
+}
+
+void SampleRoleCache::invalidate(int first, int last, quint32 roleMask)
+{
+    // Ranges longer than the cache are cheaper to check slot by slot
+    if (last - first + 1 >= SlotCount)
+    {
+        for (auto& slot : m_slots)
+        {
+            if (slot.row >= first && slot.row <= last)
+            {
+                slot.validRoles &= ~roleMask;
+            }
+        }
+        return;
+    }
+
+    for (int row = first; row <= last; ++row)
+    {
+        Slot& slot = m_slots[slotIndex(row)];
+        if (slot.row == row)
+        {
+            slot.validRoles &= ~roleMask;
+        }
+    }
+}
+
+// Values are left in place, they are overwritten when their slot is reused
+void SampleRoleCache::clear()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.row = -1;
+        slot.validRoles = 0;
+    }
+}
+
+quint32 SampleRoleCache::roleBit(int role) const
+{
+    const int index = role - m_firstRole;
+    return index >= 0 && index < m_roleCount ? 1u << index : 0u;
+}
+
+int SampleRoleCache::slotIndex(int row) const
+{
+    return row & (SlotCount - 1);
+}
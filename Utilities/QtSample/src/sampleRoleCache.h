@@ -0,0 +1,44 @@
+#pragma once
+#include <qvariant.h>
+#include <vector>
+
+/**
+* Caches the role values of recently read rows so repeated data() calls skip the store
+* Rows map directly to a fixed number of slots, views only read the rows they show
+* so a small cache covers them without growing with the model
+*/
+class SampleRoleCache
+{
+public:
+    static const int SlotCount = 4096;
+
+    SampleRoleCache(int firstRole, int roleCount);
+
+    /**
+    * Returns the cached value or null if the row and role are not cached
+    */
+    const QVariant* find(int row, int role) const;
+    void insert(int row, int role, const QVariant& value);
+
+    /**
+    * Drops the roles in roleMask, bit 0 being firstRole, for the rows first to last inclusive
+    */
+    void invalidate(int first, int last, quint32 roleMask);
+    void clear();
+
+    quint32 roleBit(int role) const;
+
+private:
+    struct Slot
+    {
+        int row = -1;
+        quint32 validRoles = 0;
+    };
+
+    int slotIndex(int row) const;
+
+    int m_firstRole;
+    int m_roleCount;
+    std::vector<Slot> m_slots;
+    std::vector<QVariant> m_values;
+};
@@ -0,0 +1,507 @@
+#include "sampleSearchProxy.h"
+#include "sampleModel.h"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    // Beyond this many ranges of changed matches a new query resets the views instead
+    const size_t MaxIncrementalRanges = 64;
+
+    // Removed entries are dropped once they outnumber the live ones and this
+    const int MinCompactEntries = 4096;
+
+    void appendToRange(std::vector<std::pair<int, int>>& ranges, int position)
+    {
+        if (!ranges.empty() && ranges.back().second == position - 1)
+        {
+            ranges.back().second = position;
+        }
+        else
+        {
+            ranges.push_back({ position, position });
+        }
+    }
+}
+
+SampleSearchProxy::SampleSearchProxy(QObject* parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+SampleSearchProxy::~SampleSearchProxy() = default;
+
+//===========================================================================================================
+// Query
+//===========================================================================================================
+
+QString SampleSearchProxy::query() const
+{
+    return m_query;
+}
+
+void SampleSearchProxy::setQuery(const QString& query)
+{
+    if (m_query != query)
+    {
+        m_query = query;
+        m_foldedQuery = SampleNameIndex::fold(query);
+        if (m_resetDepth == 0)
+        {
+            std::vector<int> rows = findRows();
+            setMatches(rows);
+        }
+        emit queryChanged();
+    }
+}
+
+SampleSearchProxy::MatchMode SampleSearchProxy::matchMode() const
+{
+    return m_matchMode;
+}
+
+void SampleSearchProxy::setMatchMode(MatchMode mode)
+{
+    if (m_matchMode != mode)
+    {
+        m_matchMode = mode;
+        if (m_resetDepth == 0)
+        {
+            std::vector<int> rows = findRows();
+            setMatches(rows);
+        }
+        emit queryChanged();
+    }
+}
+
+//===========================================================================================================
+// QAbstractProxyModel
+//===========================================================================================================
+
+void SampleSearchProxy::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+    for (const auto& connection : m_sourceConnections)
+    {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    // Names of a SampleModel are read from its store, data() would fill its role cache with every row
+    const SampleModel* model = qobject_cast<const SampleModel*>(sourceModel);
+    m_store = model ? &model->store() : nullptr;
+
+    if (sourceModel)
+    {
+        // Resets rebuild the index, moves only move the rows of its entries
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &SampleSearchProxy::onDataChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &SampleSearchProxy::onRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &SampleSearchProxy::onRowsAboutToBeRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &SampleSearchProxy::onRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this, &SampleSearchProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &SampleSearchProxy::onRowsMoved),
+            connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &SampleSearchProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &SampleSearchProxy::onLayoutChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &SampleSearchProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &SampleSearchProxy::onLayoutChanged)
+        };
+    }
+
+    rebuild();
+    endResetModel();
+}
+
+QModelIndex SampleSearchProxy::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+    {
+        return QModelIndex();
+    }
+    return sourceModel()->index(m_matches[proxyIndex.row()], proxyIndex.column());
+}
+
+QModelIndex SampleSearchProxy::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid())
+    {
+        return QModelIndex();
+    }
+
+    const auto found = std::lower_bound(m_matches.begin(), m_matches.end(), sourceIndex.row());
+    if (found == m_matches.end() || *found != sourceIndex.row())
+    {
+        return QModelIndex();
+    }
+    return index(static_cast<int>(found - m_matches.begin()), sourceIndex.column());
+}
+
+QModelIndex SampleSearchProxy::index(int row, int column, const QModelIndex& parent) const
+{
+    return hasIndex(row, column, parent) ? createIndex(row, column) : QModelIndex();
+}
+
+QModelIndex SampleSearchProxy::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int SampleSearchProxy::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_matches.size());
+}
+
+int SampleSearchProxy::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+//===========================================================================================================
+// Source Changes
+//===========================================================================================================
+
+// A renamed row is indexed as a new entry, the entry of its old name is removed
+void SampleSearchProxy::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (m_resetDepth > 0 || topLeft.parent().isValid())
+    {
+        return;
+    }
+
+    const int first = topLeft.row();
+    const int last = std::min(bottomRight.row(), static_cast<int>(m_rowEntries.size()) - 1);
+    if (roles.isEmpty() || roles.contains(SampleModel::NameRole))
+    {
+        for (int row = first; row <= last; ++row)
+        {
+            const QString name = sourceName(row);
+            m_index.remove(m_rowEntries[row]);
+            m_entryRows[m_rowEntries[row]] = -1;
+            indexRow(row, name);
+
+            const auto position = std::lower_bound(m_matches.begin(), m_matches.end(), row);
+            const int proxyRow = static_cast<int>(position - m_matches.begin());
+            const bool listed = position != m_matches.end() && *position == row;
+            const bool matched = isMatch(name);
+            if (matched && !listed)
+            {
+                beginInsertRows(QModelIndex(), proxyRow, proxyRow);
+                m_matches.insert(position, row);
+                endInsertRows();
+            }
+            else if (!matched && listed)
+            {
+                beginRemoveRows(QModelIndex(), proxyRow, proxyRow);
+                m_matches.erase(position);
+                endRemoveRows();
+            }
+        }
+        compact();
+    }
+
+    // Matches are in source order, so those in the range are contiguous
+    const auto lower = std::lower_bound(m_matches.begin(), m_matches.end(), first);
+    const auto upper = std::upper_bound(lower, m_matches.end(), last);
+    if (lower != upper)
+    {
+        emit dataChanged(createIndex(static_cast<int>(lower - m_matches.begin()), 0),
+            createIndex(static_cast<int>(upper - m_matches.begin()) - 1, 0), roles);
+    }
+}
+
+// Inserted rows that match sit between the same two matches, so they are inserted as one range
+void SampleSearchProxy::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    const int count = last - first + 1;
+    const auto position = std::lower_bound(m_matches.begin(), m_matches.end(), first);
+    const int proxyRow = static_cast<int>(position - m_matches.begin());
+    for (auto itr = position; itr != m_matches.end(); ++itr)
+    {
+        *itr += count;
+    }
+
+    m_rowEntries.insert(m_rowEntries.begin() + first, count, -1);
+    std::vector<int> matched;
+    for (int row = first; row <= last; ++row)
+    {
+        const QString name = sourceName(row);
+        indexRow(row, name);
+        if (isMatch(name))
+        {
+            matched.push_back(row);
+        }
+    }
+    if (last + 1 < static_cast<int>(m_rowEntries.size()))
+    {
+        m_entryRowsStale = true;
+    }
+
+    if (!matched.empty())
+    {
+        beginInsertRows(QModelIndex(), proxyRow, proxyRow + static_cast<int>(matched.size()) - 1);
+        m_matches.insert(m_matches.begin() + proxyRow, matched.begin(), matched.end());
+        endInsertRows();
+    }
+}
+
+// Matches leave while the source still has their rows, the rest shift once they are gone
+void SampleSearchProxy::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    const auto lower = std::lower_bound(m_matches.begin(), m_matches.end(), first);
+    const auto upper = std::upper_bound(lower, m_matches.end(), last);
+    if (lower != upper)
+    {
+        beginRemoveRows(QModelIndex(), static_cast<int>(lower - m_matches.begin()),
+            static_cast<int>(upper - m_matches.begin()) - 1);
+        m_matches.erase(lower, upper);
+        endRemoveRows();
+    }
+
+    for (int row = first; row <= last; ++row)
+    {
+        m_index.remove(m_rowEntries[row]);
+        m_entryRows[m_rowEntries[row]] = -1;
+    }
+}
+
+void SampleSearchProxy::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+
+    const int count = last - first + 1;
+    for (auto itr = std::lower_bound(m_matches.begin(), m_matches.end(), first); itr != m_matches.end(); ++itr)
+    {
+        *itr -= count;
+    }
+
+    m_rowEntries.erase(m_rowEntries.begin() + first, m_rowEntries.begin() + last + 1);
+    if (first < static_cast<int>(m_rowEntries.size()))
+    {
+        m_entryRowsStale = true;
+    }
+    compact();
+}
+
+// Moved names keep their entries, the rows of the entries are mapped again by the next query
+void SampleSearchProxy::onRowsMoved(const QModelIndex& parent, int first, int last, const QModelIndex& destination, int row)
+{
+    if (m_resetDepth == 0)
+    {
+        return;
+    }
+
+    if (!parent.isValid() && !destination.isValid())
+    {
+        const auto begin = m_rowEntries.begin();
+        if (row > last)
+        {
+            std::rotate(begin + first, begin + last + 1, begin + row);
+        }
+        else
+        {
+            std::rotate(begin + row, begin + first, begin + last + 1);
+        }
+        m_entryRowsStale = true;
+    }
+
+    if (--m_resetDepth == 0)
+    {
+        m_matches = findRows();
+        endResetModel();
+    }
+}
+
+void SampleSearchProxy::onLayoutAboutToChange()
+{
+    if (m_resetDepth++ == 0)
+    {
+        beginResetModel();
+    }
+}
+
+void SampleSearchProxy::onLayoutChanged()
+{
+    if (m_resetDepth > 0 && --m_resetDepth == 0)
+    {
+        rebuild();
+        endResetModel();
+    }
+}
+
+//===========================================================================================================
+// Matching
+//===========================================================================================================
+
+QString SampleSearchProxy::sourceName(int sourceRow) const
+{
+    return m_store ? m_store->name(sourceRow) :
+        sourceModel()->data(sourceModel()->index(sourceRow, 0), SampleModel::NameRole).toString();
+}
+
+bool SampleSearchProxy::isMatch(const QString& name) const
+{
+    if (m_foldedQuery.isEmpty())
+    {
+        return true;
+    }
+
+    const QString folded = SampleNameIndex::fold(name);
+    return m_matchMode == StartsWith ? folded.startsWith(m_foldedQuery) : folded.contains(m_foldedQuery);
+}
+
+void SampleSearchProxy::indexRow(int sourceRow, const QString& name)
+{
+    m_rowEntries[sourceRow] = m_index.add(name);
+    m_entryRows.push_back(sourceRow);
+}
+
+// Maps every entry back to its row once rows shifted since the last query
+void SampleSearchProxy::mapEntryRows() const
+{
+    if (!m_entryRowsStale)
+    {
+        return;
+    }
+
+    m_entryRows.assign(m_index.entryCount(), -1);
+    const int rows = static_cast<int>(m_rowEntries.size());
+    for (int row = 0; row < rows; ++row)
+    {
+        m_entryRows[m_rowEntries[row]] = row;
+    }
+    m_entryRowsStale = false;
+}
+
+// Rows found through the index are verified unless the query is a single trigram
+std::vector<int> SampleSearchProxy::findRows() const
+{
+    std::vector<int> rows;
+    const int rowCount = static_cast<int>(m_rowEntries.size());
+    if (m_foldedQuery.isEmpty())
+    {
+        rows.resize(rowCount);
+        std::iota(rows.begin(), rows.end(), 0);
+        return rows;
+    }
+
+    const bool prefix = m_matchMode == StartsWith;
+    std::vector<int> entries;
+    if (m_index.find(m_foldedQuery, prefix, entries))
+    {
+        const bool exact = SampleNameIndex::isExact(m_foldedQuery.size(), prefix);
+        mapEntryRows();
+        rows.reserve(entries.size());
+        for (const int entry : entries)
+        {
+            const int row = m_entryRows[entry];
+            if (exact || isMatch(sourceName(row)))
+            {
+                rows.push_back(row);
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    for (int row = 0; row < rowCount; ++row)
+    {
+        if (isMatch(sourceName(row)))
+        {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+// Merges the old and new matches in source order to find the ranges that left and joined,
+// ranges are removed from the back and inserted from the front so positions stay valid
+void SampleSearchProxy::setMatches(std::vector<int>& rows)
+{
+    std::vector<std::pair<int, int>> removed;
+    std::vector<std::pair<int, int>> inserted;
+    size_t oldPosition = 0;
+    size_t newPosition = 0;
+    while ((oldPosition < m_matches.size() || newPosition < rows.size()) &&
+        removed.size() + inserted.size() <= MaxIncrementalRanges)
+    {
+        if (newPosition == rows.size() || (oldPosition < m_matches.size() && m_matches[oldPosition] < rows[newPosition]))
+        {
+            appendToRange(removed, static_cast<int>(oldPosition++));
+        }
+        else if (oldPosition == m_matches.size() || rows[newPosition] < m_matches[oldPosition])
+        {
+            appendToRange(inserted, static_cast<int>(newPosition++));
+        }
+        else
+        {
+            ++oldPosition;
+            ++newPosition;
+        }
+    }
+
+    if (removed.size() + inserted.size() > MaxIncrementalRanges)
+    {
+        beginResetModel();
+        m_matches.swap(rows);
+        endResetModel();
+        return;
+    }
+
+    for (auto range = removed.rbegin(); range != removed.rend(); ++range)
+    {
+        beginRemoveRows(QModelIndex(), range->first, range->second);
+        m_matches.erase(m_matches.begin() + range->first, m_matches.begin() + range->second + 1);
+        endRemoveRows();
+    }
+    for (const auto& range : inserted)
+    {
+        beginInsertRows(QModelIndex(), range.first, range.second);
+        m_matches.insert(m_matches.begin() + range.first, rows.begin() + range.first, rows.begin() + range.second + 1);
+        endInsertRows();
+    }
+}
+
+void SampleSearchProxy::compact()
+{
+    if (m_index.entryCount() - m_index.liveCount() > std::max(m_index.liveCount(), MinCompactEntries))
+    {
+        reindex();
+    }
+}
+
+// Entries are numbered by row again, which drops the removed ones
+void SampleSearchProxy::reindex()
+{
+    const int rows = static_cast<int>(m_rowEntries.size());
+    m_index.clear();
+    m_index.reserve(rows);
+    m_entryRows.clear();
+    m_entryRows.reserve(rows);
+    m_entryRowsStale = false;
+    for (int row = 0; row < rows; ++row)
+    {
+        indexRow(row, sourceName(row));
+    }
+}
+
+void SampleSearchProxy::rebuild()
+{
+    m_rowEntries.assign(sourceModel() ? sourceModel()->rowCount() : 0, -1);
+    reindex();
+    m_matches = findRows();
+}
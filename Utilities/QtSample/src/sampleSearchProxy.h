@@ -0,0 +1,95 @@
+#pragma once
+#include "sampleNameIndex.h"
+#include <qabstractproxymodel.h>
+#include <vector>
+
+class SampleStore;
+
+/**
+* Filters a SampleModel to the rows whose name contains or starts with a query, ignoring case
+* Names are kept in a SampleNameIndex as rows are inserted, renamed and removed, so a new
+* query only verifies the rows the index finds instead of scanning every name. Changes of
+* the source insert and remove the affected rows, moves and resets of the source rebuild
+*/
+class SampleSearchProxy : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(MatchMode matchMode READ matchMode WRITE setMatchMode NOTIFY queryChanged)
+
+public:
+    enum MatchMode
+    {
+        Contains,
+        StartsWith
+    };
+    Q_ENUM(MatchMode)
+
+    SampleSearchProxy(QObject* parent = nullptr);
+    virtual ~SampleSearchProxy();
+
+    /**
+    * An empty query accepts every row, queries too short for the index scan the names
+    */
+    QString query() const;
+    void setQuery(const QString& query);
+    MatchMode matchMode() const;
+    void setMatchMode(MatchMode mode);
+
+    /**
+    * QAbstractProxyModel
+    */
+    virtual void setSourceModel(QAbstractItemModel* sourceModel) override;
+    virtual QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    virtual QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+    virtual QModelIndex index(int row, int column = 0, const QModelIndex& parent = QModelIndex()) const override;
+    virtual QModelIndex parent(const QModelIndex& child) const override;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+signals:
+    void queryChanged();
+
+private:
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsMoved(const QModelIndex& parent, int first, int last, const QModelIndex& destination, int row);
+    void onLayoutAboutToChange();
+    void onLayoutChanged();
+
+    QString sourceName(int sourceRow) const;
+    bool isMatch(const QString& name) const;
+    void indexRow(int sourceRow, const QString& name);
+    void mapEntryRows() const;
+    std::vector<int> findRows() const;
+
+    /**
+    * Replaces the matching rows, notifying the difference in ranges while there are few
+    */
+    void setMatches(std::vector<int>& rows);
+    void compact();
+    void reindex();
+    void rebuild();
+
+    QString m_query;
+    QString m_foldedQuery;
+    MatchMode m_matchMode = Contains;
+    int m_resetDepth = 0;
+    const SampleStore* m_store = nullptr;
+
+    /**
+    * Source rows of the matches in ascending order, the entry of every source row
+    * and the source row of every entry, -1 once the entry is removed
+    * Entries do not change as rows shift, only a new query maps them back to rows,
+    * so the rows of the entries are left stale by inserts, removes and moves until then
+    */
+    std::vector<int> m_matches;
+    std::vector<int> m_rowEntries;
+    mutable std::vector<int> m_entryRows;
+    mutable bool m_entryRowsStale = false;
+    SampleNameIndex m_index;
+    std::vector<QMetaObject::Connection> m_sourceConnections;
+};
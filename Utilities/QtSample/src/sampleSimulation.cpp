@@ -0,0 +1,331 @@
+#include "sampleSimulation.h"
+#include "sampleDirtyTracker.h"
+#include "sampleTrace.h"
+#include <qelapsedtimer.h>
+
+SampleSimulation::SampleSimulation(const SampleStore& store, int intervalMs, QObject* parent)
+    : QThread(parent)
+    , m_intervalMs(intervalMs)
+{
+    for (int row = 0; row < store.count(); ++row)
+    {
+        m_store.append(QString());
+        m_store.setMaxSteps(row, store.maxSteps(row));
+        m_store.setStepRate(row, store.stepRate(row));
+        m_store.setState(row, store.state(row));
+        m_store.setStep(row, store.step(row));
+    }
+    m_rowGenerations.assign(store.count(), 0);
+    m_store.setRowChangedFn([this](int row, int changes)
+    {
+        Q_UNUSED(changes);
+        markRow(row);
+    });
+}
+
+SampleSimulation::~SampleSimulation()
+{
+    stop();
+}
+
+//===========================================================================================================
+// Owning Thread
+//===========================================================================================================
+
+void SampleSimulation::setState(int row, SampleItem::State state)
+{
+    pushCommand(Command::SetState, row, 1, state, false);
+}
+
+void SampleSimulation::setStep(int row, int step)
+{
+    pushCommand(Command::SetStep, row, 1, step, false);
+}
+
+void SampleSimulation::setMaxSteps(int row, int maxSteps)
+{
+    pushCommand(Command::SetMaxSteps, row, 1, maxSteps, false);
+}
+
+void SampleSimulation::setStepRate(int row, int stepRate)
+{
+    pushCommand(Command::SetStepRate, row, 1, stepRate, false);
+}
+
+void SampleSimulation::insertRows(int count)
+{
+    pushCommand(Command::Insert, -1, count, 0, true);
+}
+
+void SampleSimulation::removeRows(int row, int count)
+{
+    pushCommand(Command::Remove, row, count, 0, true);
+}
+
+void SampleSimulation::moveRows(int from, int count, int to)
+{
+    pushCommand(Command::Move, from, count, to, true);
+}
+
+void SampleSimulation::pushCommand(Command::Type type, int row, int count, int value, bool changesLayout)
+{
+    const Command command = { type, row, count, value, ++m_sentSequence };
+    if (changesLayout)
+    {
+        m_layoutSequence = command.sequence;
+    }
+
+    QMutexLocker lock(&m_commandMutex);
+    m_commands.push_back(command);
+    m_commandReady.wakeAll();
+}
+
+bool SampleSimulation::sync(SampleStore& store)
+{
+    if (!m_snapshots.update())
+    {
+        return false;
+    }
+
+    // Snapshots taken before the last structural command describe a different row layout,
+    // the worker publishes all rows again once it has caught up with the commands
+    const Snapshot& snapshot = m_snapshots.readBuffer();
+    if (snapshot.sequence < m_layoutSequence || snapshot.rowCount != store.count())
+    {
+        return false;
+    }
+
+    const int rows = static_cast<int>(snapshot.states.size());
+    for (int i = 0; i < rows; ++i)
+    {
+        const int row = snapshot.full ? i : snapshot.rows[i];
+        const auto state = static_cast<SampleItem::State>(snapshot.states[i]);
+        if (store.state(row) != state)
+        {
+            store.setState(row, state);
+        }
+        if (store.step(row) != snapshot.steps[i])
+        {
+            store.setStep(row, snapshot.steps[i]);
+        }
+    }
+    m_syncedSequence = snapshot.sequence;
+    return true;
+}
+
+bool SampleSimulation::isSynced() const
+{
+    return m_syncedSequence == m_sentSequence;
+}
+
+void SampleSimulation::stop()
+{
+    {
+        QMutexLocker lock(&m_commandMutex);
+        m_stopRequested = true;
+        m_commandReady.wakeAll();
+    }
+    wait();
+}
+
+//===========================================================================================================
+// Worker Thread
+//===========================================================================================================
+
+void SampleSimulation::run()
+{
+    SampleDirtyTracker dirtyRows;
+    QElapsedTimer timer;
+    timer.start();
+    qint64 nextTickMs = 0;
+
+    for (;;)
+    {
+        // Scoped so the trace event ends before the thread sleeps
+        bool stepped = false;
+        {
+            SAMPLE_TRACE_SCOPE("simulation", "tick");
+            const bool changed = applyCommands();
+            m_store.tickActiveRows(dirtyRows);
+            stepped = !dirtyRows.isEmpty();
+            dirtyRows.flush([this](int first, int last, int changes)
+            {
+                Q_UNUSED(changes);
+                for (int row = first; row <= last; ++row)
+                {
+                    markRow(row);
+                }
+            });
+
+            if (changed || stepped)
+            {
+                publishSnapshot();
+            }
+        }
+
+        // Sleep until the next command once nothing is left to step
+        bool stopping = false;
+        {
+            QMutexLocker lock(&m_commandMutex);
+            if (!stepped)
+            {
+                while (m_commands.empty() && !m_stopRequested)
+                {
+                    m_commandReady.wait(&m_commandMutex);
+                    nextTickMs = timer.elapsed() - m_intervalMs;
+                }
+            }
+            stopping = m_stopRequested;
+        }
+
+        // Commands sent just before stopping are applied and published without stepping,
+        // so the last sync of the owning thread includes them
+        if (stopping)
+        {
+            applyCommands();
+            publishSnapshot();
+            return;
+        }
+
+        // Keep a fixed rate, skipping ahead rather than catching up if a tick overran
+        nextTickMs += m_intervalMs;
+        const qint64 waitMs = nextTickMs - timer.elapsed();
+        if (waitMs > 0)
+        {
+            QThread::msleep(static_cast<unsigned long>(waitMs));
+        }
+        else
+        {
+            nextTickMs = timer.elapsed();
+        }
+    }
+}
+
+bool SampleSimulation::applyCommands()
+{
+    {
+        QMutexLocker lock(&m_commandMutex);
+        m_pendingCommands.swap(m_commands);
+    }
+
+    if (m_pendingCommands.empty())
+    {
+        return false;
+    }
+
+    for (const auto& command : m_pendingCommands)
+    {
+        const bool validRows = command.row >= 0 && command.row + command.count <= m_store.count();
+        switch (command.type)
+        {
+        case Command::SetState:
+            if (validRows)
+            {
+                m_store.setState(command.row, static_cast<SampleItem::State>(command.value));
+            }
+            break;
+        case Command::SetStep:
+            if (validRows)
+            {
+                m_store.setStep(command.row, command.value);
+            }
+            break;
+        case Command::SetMaxSteps:
+            if (validRows)
+            {
+                m_store.setMaxSteps(command.row, command.value);
+            }
+            break;
+        case Command::SetStepRate:
+            if (validRows)
+            {
+                m_store.setStepRate(command.row, command.value);
+            }
+            break;
+        case Command::Insert:
+            for (int i = 0; i < command.count; ++i)
+            {
+                m_store.append(QString());
+            }
+            m_rowGenerations.resize(m_store.count(), 0);
+            m_layoutGeneration = m_generation;
+            break;
+        case Command::Remove:
+            if (validRows)
+            {
+                m_store.remove(command.row, command.count);
+            }
+            m_layoutGeneration = m_generation;
+            break;
+        case Command::Move:
+            if (validRows && command.value >= 0 && command.value + command.count <= m_store.count())
+            {
+                m_store.move(command.row, command.count, command.value);
+            }
+            m_layoutGeneration = m_generation;
+            break;
+        }
+        m_appliedSequence = command.sequence;
+    }
+
+    m_pendingCommands.clear();
+
+    // Listed rows no longer match the layout, all rows are published until that is picked up
+    if (m_layoutGeneration == m_generation)
+    {
+        m_changedRows.clear();
+        m_publishedRows = 0;
+        m_rowGenerations.assign(m_store.count(), 0);
+    }
+    return true;
+}
+
+void SampleSimulation::markRow(int row)
+{
+    if (m_rowGenerations[row] != m_generation)
+    {
+        m_rowGenerations[row] = m_generation;
+        m_changedRows.push_back(row);
+    }
+}
+
+// A publish replacing one the owning thread never picked up carries its rows along,
+// once one is picked up the rows it held are dropped
+void SampleSimulation::publishSnapshot()
+{
+    Snapshot& snapshot = m_snapshots.writeBuffer();
+    const int rows = m_store.count();
+    snapshot.full = m_layoutGeneration > m_pickedUpGeneration;
+    snapshot.rowCount = rows;
+    snapshot.rows.clear();
+    snapshot.states.clear();
+    snapshot.steps.clear();
+    if (snapshot.full)
+    {
+        snapshot.states.resize(rows);
+        snapshot.steps.resize(rows);
+        for (int row = 0; row < rows; ++row)
+        {
+            snapshot.states[row] = static_cast<uint8_t>(m_store.state(row));
+            snapshot.steps[row] = m_store.step(row);
+        }
+    }
+    else
+    {
+        snapshot.rows = m_changedRows;
+        for (const int row : m_changedRows)
+        {
+            snapshot.states.push_back(static_cast<uint8_t>(m_store.state(row)));
+            snapshot.steps.push_back(m_store.step(row));
+        }
+    }
+    snapshot.sequence = m_appliedSequence;
+
+    if (m_snapshots.publish())
+    {
+        m_pickedUpGeneration = m_generation - 1;
+        m_changedRows.erase(m_changedRows.begin(), m_changedRows.begin() + m_publishedRows);
+    }
+    m_publishedRows = m_changedRows.size();
+    ++m_generation;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "sampleColumnStore.h"
+#include "sampleTripleBuffer.h"
+#include <qthread.h>
+#include <qmutex.h>
+#include <qwaitcondition.h>
+#include <vector>
+#include <cstdint>
+
+/**
+* Steps a copy of the model rows on a worker thread
+* The owning thread forwards changes as commands and picks up the latest
+* published snapshot without locking, applying the rows it holds to its store
+* Snapshots hold the rows changed since the last snapshot the owning thread is known
+* to have picked up, all rows only after commands that changed the row layout
+*/
+class SampleSimulation : public QThread
+{
+public:
+    SampleSimulation(const SampleStore& store, int intervalMs, QObject* parent = nullptr);
+    virtual ~SampleSimulation();
+
+    /**
+    * Commands, called from the owning thread
+    */
+    void setState(int row, SampleItem::State state);
+    void setStep(int row, int step);
+    void setMaxSteps(int row, int maxSteps);
+    void setStepRate(int row, int stepRate);
+    void insertRows(int count);
+    void removeRows(int row, int count);
+    void moveRows(int from, int count, int to);
+
+    /**
+    * Applies the latest snapshot to the store, returns false if there was nothing new
+    */
+    bool sync(SampleStore& store);
+
+    /**
+    * Returns true once the last applied snapshot includes every command sent
+    */
+    bool isSynced() const;
+    void stop();
+
+protected:
+    virtual void run() override;
+
+private:
+    struct Command
+    {
+        enum Type
+        {
+            SetState,
+            SetStep,
+            SetMaxSteps,
+            SetStepRate,
+            Insert,
+            Remove,
+            Move
+        };
+
+        Type type;
+        int row;
+        int count;
+        int value;
+        quint64 sequence;
+    };
+
+    /**
+    * States and steps of the listed rows, or of every row if full is set
+    */
+    struct Snapshot
+    {
+        std::vector<int> rows;
+        std::vector<uint8_t> states;
+        std::vector<int> steps;
+        int rowCount = 0;
+        bool full = false;
+        quint64 sequence = 0;
+    };
+
+    void pushCommand(Command::Type type, int row, int count, int value, bool changesLayout);
+    bool applyCommands();
+    void markRow(int row);
+    void publishSnapshot();
+
+    // Owned by the worker thread
+    SampleColumnStore m_store;
+    quint64 m_appliedSequence = 0;
+
+    // Rows changed since the last publish known to be picked up, the first m_publishedRows
+    // of them were already in the last publish. Publishes are numbered by generation,
+    // m_rowGenerations keeps a row from being listed twice within one
+    std::vector<int> m_changedRows;
+    size_t m_publishedRows = 0;
+    std::vector<quint64> m_rowGenerations;
+    quint64 m_generation = 1;
+    quint64 m_pickedUpGeneration = 0;
+    quint64 m_layoutGeneration = 0;
+
+    // Owned by the owning thread
+    quint64 m_sentSequence = 0;
+    quint64 m_layoutSequence = 0;
+    quint64 m_syncedSequence = 0;
+
+    QMutex m_commandMutex;
+    QWaitCondition m_commandReady;
+    std::vector<Command> m_commands;
+    std::vector<Command> m_pendingCommands;
+    SampleTripleBuffer<Snapshot> m_snapshots;
+    bool m_stopRequested = false;
+    const int m_intervalMs;
+};
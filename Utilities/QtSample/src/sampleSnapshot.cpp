@@ -0,0 +1,168 @@
+#include "sampleSnapshot.h"
+#include "sampleStore.h"
+#include <qsavefile.h>
+#include <vector>
+
+// "SMSN" read as a little endian integer
+const quint32 SampleSnapshot::Magic = 0x4E534D53;
+// Version 2 adds the step rate column
+const quint16 SampleSnapshot::Version = 2;
+
+SampleSnapshot::SampleSnapshot() = default;
+SampleSnapshot::~SampleSnapshot()
+{
+    close();
+}
+
+bool SampleSnapshot::write(const SampleStore& store, const QString& path)
+{
+    const int rows = store.count();
+    std::vector<quint8> states(static_cast<size_t>(statesSize(rows)), 0);
+    std::vector<qint32> steps(rows);
+    std::vector<qint32> maxSteps(rows);
+    std::vector<qint32> stepRates(rows);
+    std::vector<quint32> nameOffsets(rows + 1);
+    QString names;
+    for (int row = 0; row < rows; ++row)
+    {
+        states[row] = static_cast<quint8>(store.state(row));
+        steps[row] = store.step(row);
+        maxSteps[row] = store.maxSteps(row);
+        stepRates[row] = store.stepRate(row);
+        nameOffsets[row] = static_cast<quint32>(names.size());
+        names += store.name(row);
+    }
+    nameOffsets[rows] = static_cast<quint32>(names.size());
+
+    const Header header = { Magic, Version, sizeof(Header),
+        static_cast<quint32>(rows), static_cast<quint32>(names.size()) };
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(states.data()), static_cast<qint64>(states.size()));
+    file.write(reinterpret_cast<const char*>(steps.data()), static_cast<qint64>(steps.size() * sizeof(qint32)));
+    file.write(reinterpret_cast<const char*>(maxSteps.data()), static_cast<qint64>(maxSteps.size() * sizeof(qint32)));
+    file.write(reinterpret_cast<const char*>(stepRates.data()), static_cast<qint64>(stepRates.size() * sizeof(qint32)));
+    file.write(reinterpret_cast<const char*>(nameOffsets.data()), static_cast<qint64>(nameOffsets.size() * sizeof(quint32)));
+    file.write(reinterpret_cast<const char*>(names.constData()), static_cast<qint64>(names.size() * sizeof(QChar)));
+    return file.commit();
+}
+
+bool SampleSnapshot::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < static_cast<qint64>(sizeof(Header)))
+    {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_file.size());
+    const Header* header = reinterpret_cast<const Header*>(m_data);
+    if (!m_data || header->magic != Magic || header->version != Version ||
+        header->headerSize != sizeof(Header) ||
+        m_file.size() != snapshotSize(header->rowCount, header->nameLength))
+    {
+        close();
+        return false;
+    }
+
+    const quint32 rows = header->rowCount;
+    const uchar* column = m_data + sizeof(Header);
+    m_states = column;
+    column += statesSize(rows);
+    m_steps = reinterpret_cast<const qint32*>(column);
+    column += rows * sizeof(qint32);
+    m_maxSteps = reinterpret_cast<const qint32*>(column);
+    column += rows * sizeof(qint32);
+    m_stepRates = reinterpret_cast<const qint32*>(column);
+    column += rows * sizeof(qint32);
+    m_nameOffsets = reinterpret_cast<const quint32*>(column);
+    column += (rows + 1) * sizeof(quint32);
+    m_names = reinterpret_cast<const QChar*>(column);
+
+    if (m_nameOffsets[rows] != header->nameLength)
+    {
+        close();
+        return false;
+    }
+    m_count = static_cast<int>(rows);
+    return true;
+}
+
+void SampleSnapshot::close()
+{
+    if (m_data)
+    {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_count = 0;
+    m_states = nullptr;
+    m_steps = nullptr;
+    m_maxSteps = nullptr;
+    m_stepRates = nullptr;
+    m_nameOffsets = nullptr;
+    m_names = nullptr;
+}
+
+QString SampleSnapshot::path() const
+{
+    return m_file.fileName();
+}
+
+int SampleSnapshot::count() const
+{
+    return m_count;
+}
+
+const quint8* SampleSnapshot::states() const
+{
+    return m_states;
+}
+
+const qint32* SampleSnapshot::steps() const
+{
+    return m_steps;
+}
+
+const qint32* SampleSnapshot::maxSteps() const
+{
+    return m_maxSteps;
+}
+
+const qint32* SampleSnapshot::stepRates() const
+{
+    return m_stepRates;
+}
+
+QString SampleSnapshot::name(int row) const
+{
+    const quint32 first = m_nameOffsets[row];
+    const quint32 last = m_nameOffsets[row + 1];
+    if (last < first || last > m_nameOffsets[m_count])
+    {
+        return QString();
+    }
+    return QString(m_names + first, static_cast<int>(last - first));
+}
+
+// States are padded so the integer columns that follow stay aligned
+qint64 SampleSnapshot::statesSize(quint32 rows)
+{
+    return (static_cast<qint64>(rows) + 3) & ~static_cast<qint64>(3);
+}
+
+qint64 SampleSnapshot::snapshotSize(quint32 rows, quint32 nameLength)
+{
+    return static_cast<qint64>(sizeof(Header)) + statesSize(rows) +
+        static_cast<qint64>(rows) * sizeof(qint32) * 3 +
+        (static_cast<qint64>(rows) + 1) * sizeof(quint32) +
+        static_cast<qint64>(nameLength) * sizeof(QChar);
+}
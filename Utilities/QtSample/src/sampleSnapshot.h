@@ -0,0 +1,65 @@
+#pragma once
+#include <qfile.h>
+#include <qstring.h>
+
+class SampleStore;
+
+/**
+* Binary snapshot of the rows of a store, laid out as columns so each is copied from
+* the mapped file in one pass: the header, then the states, steps, max steps, step rates, the
+* offsets of every name and finally the names as UTF-16, all in native byte order
+* Snapshots are written through a temporary file renamed over the target on success,
+* snapshots of another version are rejected as invalid
+*/
+class SampleSnapshot
+{
+public:
+    static const quint32 Magic;
+    static const quint16 Version;
+
+    SampleSnapshot();
+    ~SampleSnapshot();
+
+    static bool write(const SampleStore& store, const QString& path);
+
+    /**
+    * Maps the snapshot, returns false if it is missing or not a valid snapshot
+    */
+    bool open(const QString& path);
+    void close();
+
+    QString path() const;
+    int count() const;
+    const quint8* states() const;
+    const qint32* steps() const;
+    const qint32* maxSteps() const;
+    const qint32* stepRates() const;
+
+    /**
+    * Returns a copy of the name, it stays valid after the snapshot is closed
+    */
+    QString name(int row) const;
+
+private:
+    struct Header
+    {
+        quint32 magic;
+        quint16 version;
+        quint16 headerSize;
+        quint32 rowCount;
+        quint32 nameLength;
+    };
+
+    static qint64 statesSize(quint32 rows);
+    static qint64 snapshotSize(quint32 rows, quint32 nameLength);
+
+    QFile m_file;
+    uchar* m_data = nullptr;
+    int m_count = 0;
+    const quint8* m_states = nullptr;
+    const qint32* m_steps = nullptr;
+    const qint32* m_maxSteps = nullptr;
+    const qint32* m_stepRates = nullptr;
+    const quint32* m_nameOffsets = nullptr;
+    const QChar* m_names = nullptr;
+};
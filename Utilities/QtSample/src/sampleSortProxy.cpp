@@ -0,0 +1,655 @@
+#include "sampleSortProxy.h"
+#include "sampleModel.h"
+#include <algorithm>
+
+SampleSortProxy::SampleSortProxy(QObject* parent)
+    : QAbstractProxyModel(parent)
+    , m_random(1234)
+{
+}
+
+SampleSortProxy::~SampleSortProxy() = default;
+
+//===========================================================================================================
+// Sorting and Filtering
+//===========================================================================================================
+
+int SampleSortProxy::sortRole() const
+{
+    return m_sortRole;
+}
+
+void SampleSortProxy::setSortRole(int role)
+{
+    if (m_sortRole != role)
+    {
+        beginResetModel();
+        m_sortRole = role;
+        rebuild();
+        endResetModel();
+        emit sortChanged();
+    }
+}
+
+Qt::SortOrder SampleSortProxy::sortOrder() const
+{
+    return m_sortOrder;
+}
+
+void SampleSortProxy::setSortOrder(Qt::SortOrder order)
+{
+    if (m_sortOrder != order)
+    {
+        beginResetModel();
+        m_sortOrder = order;
+        rebuild();
+        endResetModel();
+        emit sortChanged();
+    }
+}
+
+int SampleSortProxy::stateFilter() const
+{
+    return m_stateFilter;
+}
+
+void SampleSortProxy::setStateFilter(int stateFilter)
+{
+    if (m_stateFilter != stateFilter)
+    {
+        beginResetModel();
+        m_stateFilter = stateFilter;
+        rebuild();
+        endResetModel();
+        emit stateFilterChanged();
+    }
+}
+
+void SampleSortProxy::setStateAccepted(int state, bool accepted)
+{
+    const int bit = 1 << state;
+    setStateFilter(accepted ? m_stateFilter | bit : m_stateFilter & ~bit);
+}
+
+// Column is ignored as the model is a list
+void SampleSortProxy::sort(int column, Qt::SortOrder order)
+{
+    Q_UNUSED(column);
+    setSortOrder(order);
+}
+
+//===========================================================================================================
+// QAbstractProxyModel
+//===========================================================================================================
+
+void SampleSortProxy::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+    for (const auto& connection : m_sourceConnections)
+    {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    if (sourceModel)
+    {
+        // Only resets and layout changes of the source rebuild the tree
+        m_sourceConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &SampleSortProxy::onDataChanged),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &SampleSortProxy::onRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &SampleSortProxy::onRowsAboutToBeRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &SampleSortProxy::onRowsRemoved),
+            connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this, &SampleSortProxy::onRowsAboutToBeMoved),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &SampleSortProxy::onRowsMoved),
+            connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &SampleSortProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &SampleSortProxy::onLayoutChanged),
+            connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, &SampleSortProxy::onLayoutAboutToChange),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &SampleSortProxy::onLayoutChanged)
+        };
+    }
+
+    rebuild();
+    endResetModel();
+}
+
+QModelIndex SampleSortProxy::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel())
+    {
+        return QModelIndex();
+    }
+    return sourceModel()->index(select(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex SampleSortProxy::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    const int row = sourceIndex.row();
+    if (!sourceIndex.isValid() || row >= static_cast<int>(m_inTree.size()) || !m_inTree[row])
+    {
+        return QModelIndex();
+    }
+    return index(proxyRow(row), sourceIndex.column());
+}
+
+QModelIndex SampleSortProxy::index(int row, int column, const QModelIndex& parent) const
+{
+    return hasIndex(row, column, parent) ? createIndex(row, column) : QModelIndex();
+}
+
+QModelIndex SampleSortProxy::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int SampleSortProxy::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : nodeSize(m_root);
+}
+
+int SampleSortProxy::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+//===========================================================================================================
+// Source Changes
+//===========================================================================================================
+
+// Only rows whose sort value or state changed are repositioned
+void SampleSortProxy::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (m_resetDepth > 0 || topLeft.parent().isValid())
+    {
+        return;
+    }
+
+    const bool keysChanged = roles.isEmpty() || roles.contains(m_sortRole) ||
+        roles.contains(SampleModel::StateValueRole);
+    std::vector<int> changedRows;
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+    {
+        if (keysChanged)
+        {
+            updateRow(row, changedRows, roles);
+        }
+        else if (m_inTree[row])
+        {
+            changedRows.push_back(proxyRow(row));
+        }
+    }
+    emitChangedRows(changedRows, roles);
+}
+
+void SampleSortProxy::onRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+    insertSourceRows(first, last);
+}
+
+// The nodes are erased while the source rows still exist, so views can map them until they are gone
+void SampleSortProxy::onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+    removeAcceptedRows(first, last);
+}
+
+void SampleSortProxy::onRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    if (m_resetDepth > 0 || parent.isValid())
+    {
+        return;
+    }
+    eraseSourceRows(first, last);
+}
+
+// Moved rows keep their keys, only their order among equal keys changes, so they are
+// taken out of the tree and inserted again at their new source rows
+void SampleSortProxy::onRowsAboutToBeMoved(const QModelIndex& sourceParent, int first, int last,
+    const QModelIndex& destinationParent, int destination)
+{
+    Q_UNUSED(destination);
+    if (m_resetDepth > 0 || sourceParent.isValid() || destinationParent.isValid())
+    {
+        return;
+    }
+    removeAcceptedRows(first, last);
+}
+
+void SampleSortProxy::onRowsMoved(const QModelIndex& sourceParent, int first, int last,
+    const QModelIndex& destinationParent, int destination)
+{
+    if (m_resetDepth > 0 || sourceParent.isValid() || destinationParent.isValid())
+    {
+        return;
+    }
+
+    const int count = last - first + 1;
+    const int to = destination > last ? destination - count : destination;
+    eraseSourceRows(first, last);
+    insertSourceRows(to, to + count - 1);
+}
+
+void SampleSortProxy::onLayoutAboutToChange()
+{
+    if (m_resetDepth++ == 0)
+    {
+        beginResetModel();
+    }
+}
+
+void SampleSortProxy::onLayoutChanged()
+{
+    if (m_resetDepth > 0 && --m_resetDepth == 0)
+    {
+        rebuild();
+        endResetModel();
+    }
+}
+
+void SampleSortProxy::updateRow(int sourceRow, std::vector<int>& changedRows, const QVector<int>& roles)
+{
+    int key = 0;
+    bool accepted = false;
+    readRow(sourceRow, key, accepted);
+
+    if (!m_inTree[sourceRow])
+    {
+        m_keys[sourceRow] = key;
+        if (accepted)
+        {
+            emitChangedRows(changedRows, roles);
+            const int row = countLess(key, sourceRow);
+            beginInsertRows(QModelIndex(), row, row);
+            insertNode(sourceRow);
+            endInsertRows();
+        }
+        return;
+    }
+
+    const int oldRow = proxyRow(sourceRow);
+    if (!accepted)
+    {
+        emitChangedRows(changedRows, roles);
+        beginRemoveRows(QModelIndex(), oldRow, oldRow);
+        eraseNode(sourceRow);
+        endRemoveRows();
+        return;
+    }
+
+    if (key == m_keys[sourceRow])
+    {
+        changedRows.push_back(oldRow);
+        return;
+    }
+
+    // The row itself is still counted when its new key sorts after the old one
+    const int less = countLess(key, sourceRow);
+    const int newRow = m_keys[sourceRow] < key ? less - 1 : less;
+    if (newRow == oldRow)
+    {
+        eraseNode(sourceRow);
+        m_keys[sourceRow] = key;
+        insertNode(sourceRow);
+        changedRows.push_back(oldRow);
+        return;
+    }
+
+    emitChangedRows(changedRows, roles);
+    beginMoveRows(QModelIndex(), oldRow, oldRow, QModelIndex(), newRow > oldRow ? newRow + 1 : newRow);
+    eraseNode(sourceRow);
+    m_keys[sourceRow] = key;
+    insertNode(sourceRow);
+    endMoveRows();
+    changedRows.push_back(newRow);
+}
+
+// Emits one dataChanged per contiguous range of proxy rows
+void SampleSortProxy::emitChangedRows(std::vector<int>& changedRows, const QVector<int>& roles)
+{
+    if (changedRows.empty())
+    {
+        return;
+    }
+
+    std::sort(changedRows.begin(), changedRows.end());
+    size_t first = 0;
+    for (size_t i = 1; i <= changedRows.size(); ++i)
+    {
+        if (i == changedRows.size() || changedRows[i] > changedRows[i - 1] + 1)
+        {
+            emit dataChanged(index(changedRows[first]), index(changedRows[i - 1]), roles);
+            first = i;
+        }
+    }
+    changedRows.clear();
+}
+
+void SampleSortProxy::readRow(int sourceRow, int& key, bool& accepted) const
+{
+    const QModelIndex sourceIndex = sourceModel()->index(sourceRow, 0);
+    key = m_sortRole >= 0 ? sourceModel()->data(sourceIndex, m_sortRole).toInt() : 0;
+    if (m_sortOrder == Qt::DescendingOrder)
+    {
+        key = -key;
+    }
+
+    const int state = sourceModel()->data(sourceIndex, SampleModel::StateValueRole).toInt();
+    accepted = state >= 0 && state < 32 && ((m_stateFilter >> state) & 1);
+}
+
+// Sorts the accepted rows and builds the tree from them in linear time
+void SampleSortProxy::rebuild()
+{
+    const int rows = sourceModel() ? sourceModel()->rowCount() : 0;
+    m_keys.assign(rows, 0);
+    m_inTree.assign(rows, false);
+    m_left.assign(rows, -1);
+    m_right.assign(rows, -1);
+    m_size.assign(rows, 0);
+    m_priority.resize(rows);
+    m_root = -1;
+
+    std::vector<int> sorted;
+    sorted.reserve(rows);
+    for (int row = 0; row < rows; ++row)
+    {
+        bool accepted = false;
+        readRow(row, m_keys[row], accepted);
+        if (accepted)
+        {
+            m_inTree[row] = true;
+            m_priority[row] = m_random();
+            sorted.push_back(row);
+        }
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [this](int left, int right)
+    {
+        return m_keys[left] < m_keys[right] || (m_keys[left] == m_keys[right] && left < right);
+    });
+
+    // Cartesian tree over the sorted rows, the stack holds the right spine
+    std::vector<int> spine;
+    for (const int node : sorted)
+    {
+        int last = -1;
+        while (!spine.empty() && m_priority[spine.back()] < m_priority[node])
+        {
+            last = spine.back();
+            spine.pop_back();
+        }
+        m_left[node] = last;
+        if (!spine.empty())
+        {
+            m_right[spine.back()] = node;
+        }
+        spine.push_back(node);
+    }
+
+    m_root = spine.empty() ? -1 : spine.front();
+    computeSizes(m_root);
+}
+
+void SampleSortProxy::insertSourceRows(int first, int last)
+{
+    const int count = last - first + 1;
+    shiftNodes(first, count);
+    m_keys.insert(m_keys.begin() + first, count, 0);
+    m_inTree.insert(m_inTree.begin() + first, count, false);
+    m_left.insert(m_left.begin() + first, count, -1);
+    m_right.insert(m_right.begin() + first, count, -1);
+    m_size.insert(m_size.begin() + first, count, 0);
+    m_priority.insert(m_priority.begin() + first, count, 0);
+    insertAcceptedRows(first, last);
+}
+
+// The erased rows are no longer in the tree, so no link points at them
+void SampleSortProxy::eraseSourceRows(int first, int last)
+{
+    shiftNodes(last + 1, first - last - 1);
+    m_keys.erase(m_keys.begin() + first, m_keys.begin() + last + 1);
+    m_inTree.erase(m_inTree.begin() + first, m_inTree.begin() + last + 1);
+    m_left.erase(m_left.begin() + first, m_left.begin() + last + 1);
+    m_right.erase(m_right.begin() + first, m_right.begin() + last + 1);
+    m_size.erase(m_size.begin() + first, m_size.begin() + last + 1);
+    m_priority.erase(m_priority.begin() + first, m_priority.begin() + last + 1);
+}
+
+// Inserts in proxy order, so rows that land next to each other share one insert
+void SampleSortProxy::insertAcceptedRows(int first, int last)
+{
+    std::vector<int> inserted;
+    for (int row = first; row <= last; ++row)
+    {
+        bool accepted = false;
+        readRow(row, m_keys[row], accepted);
+        if (accepted)
+        {
+            inserted.push_back(row);
+        }
+    }
+
+    std::sort(inserted.begin(), inserted.end(), [this](int left, int right)
+    {
+        return m_keys[left] < m_keys[right] || (m_keys[left] == m_keys[right] && left < right);
+    });
+
+    size_t begin = 0;
+    while (begin < inserted.size())
+    {
+        // A following row joins the range while no row of the tree sorts before it and after the range
+        const int proxyFirst = countLess(m_keys[inserted[begin]], inserted[begin]);
+        size_t end = begin + 1;
+        while (end < inserted.size() && countLess(m_keys[inserted[end]], inserted[end]) == proxyFirst)
+        {
+            ++end;
+        }
+
+        beginInsertRows(QModelIndex(), proxyFirst, proxyFirst + static_cast<int>(end - begin) - 1);
+        for (size_t i = begin; i < end; ++i)
+        {
+            insertNode(inserted[i]);
+        }
+        endInsertRows();
+        begin = end;
+    }
+}
+
+// Removes from the last proxy row down, so the rows still to be removed keep their proxy rows
+void SampleSortProxy::removeAcceptedRows(int first, int last)
+{
+    std::vector<int> removed;
+    for (int row = first; row <= last; ++row)
+    {
+        if (m_inTree[row])
+        {
+            removed.push_back(proxyRow(row));
+        }
+    }
+
+    std::sort(removed.begin(), removed.end());
+    size_t end = removed.size();
+    while (end > 0)
+    {
+        size_t begin = end - 1;
+        while (begin > 0 && removed[begin - 1] + 1 == removed[begin])
+        {
+            --begin;
+        }
+
+        beginRemoveRows(QModelIndex(), removed[begin], removed[end - 1]);
+        for (size_t i = end; i > begin; --i)
+        {
+            eraseNode(select(removed[i - 1]));
+        }
+        endRemoveRows();
+        end = begin;
+    }
+}
+
+// Renumbers the nodes of source rows from first on, renumbering keeps their order
+void SampleSortProxy::shiftNodes(int first, int delta)
+{
+    const auto shifted = [first, delta](int node)
+    {
+        return node >= first ? node + delta : node;
+    };
+
+    for (size_t node = 0; node < m_left.size(); ++node)
+    {
+        m_left[node] = shifted(m_left[node]);
+        m_right[node] = shifted(m_right[node]);
+    }
+    m_root = shifted(m_root);
+}
+
+//===========================================================================================================
+// Order Statistics Tree
+//===========================================================================================================
+
+bool SampleSortProxy::nodeLess(int node, int key, int row) const
+{
+    return m_keys[node] < key || (m_keys[node] == key && node < row);
+}
+
+// Number of rows in the tree ordered before (key, row)
+int SampleSortProxy::countLess(int key, int row) const
+{
+    int count = 0;
+    int node = m_root;
+    while (node >= 0)
+    {
+        if (nodeLess(node, key, row))
+        {
+            count += nodeSize(m_left[node]) + 1;
+            node = m_right[node];
+        }
+        else
+        {
+            node = m_left[node];
+        }
+    }
+    return count;
+}
+
+int SampleSortProxy::proxyRow(int sourceRow) const
+{
+    return countLess(m_keys[sourceRow], sourceRow);
+}
+
+int SampleSortProxy::select(int proxyRow) const
+{
+    int node = m_root;
+    while (node >= 0)
+    {
+        const int leftSize = nodeSize(m_left[node]);
+        if (proxyRow < leftSize)
+        {
+            node = m_left[node];
+        }
+        else if (proxyRow == leftSize)
+        {
+            return node;
+        }
+        else
+        {
+            proxyRow -= leftSize + 1;
+            node = m_right[node];
+        }
+    }
+    return -1;
+}
+
+int SampleSortProxy::nodeSize(int node) const
+{
+    return node >= 0 ? m_size[node] : 0;
+}
+
+void SampleSortProxy::updateSize(int node)
+{
+    m_size[node] = nodeSize(m_left[node]) + nodeSize(m_right[node]) + 1;
+}
+
+int SampleSortProxy::computeSizes(int node)
+{
+    if (node < 0)
+    {
+        return 0;
+    }
+    m_size[node] = computeSizes(m_left[node]) + computeSizes(m_right[node]) + 1;
+    return m_size[node];
+}
+
+// Splits the subtree into the nodes ordered before (key, row) and the rest
+void SampleSortProxy::split(int node, int key, int row, int& left, int& right)
+{
+    if (node < 0)
+    {
+        left = right = -1;
+    }
+    else if (nodeLess(node, key, row))
+    {
+        split(m_right[node], key, row, m_right[node], right);
+        left = node;
+        updateSize(node);
+    }
+    else
+    {
+        split(m_left[node], key, row, left, m_left[node]);
+        right = node;
+        updateSize(node);
+    }
+}
+
+int SampleSortProxy::merge(int left, int right)
+{
+    if (left < 0 || right < 0)
+    {
+        return left < 0 ? right : left;
+    }
+
+    if (m_priority[left] > m_priority[right])
+    {
+        m_right[left] = merge(m_right[left], right);
+        updateSize(left);
+        return left;
+    }
+
+    m_left[right] = merge(left, m_left[right]);
+    updateSize(right);
+    return right;
+}
+
+void SampleSortProxy::insertNode(int sourceRow)
+{
+    m_left[sourceRow] = -1;
+    m_right[sourceRow] = -1;
+    m_size[sourceRow] = 1;
+    m_priority[sourceRow] = m_random();
+    m_inTree[sourceRow] = true;
+
+    int left = -1;
+    int right = -1;
+    split(m_root, m_keys[sourceRow], sourceRow, left, right);
+    m_root = merge(merge(left, sourceRow), right);
+}
+
+// Source rows are unique, so the node is the only one between (key, row) and (key, row + 1)
+void SampleSortProxy::eraseNode(int sourceRow)
+{
+    int left = -1;
+    int middle = -1;
+    int right = -1;
+    split(m_root, m_keys[sourceRow], sourceRow, left, right);
+    split(right, m_keys[sourceRow], sourceRow + 1, middle, right);
+    m_root = merge(left, right);
+    m_inTree[sourceRow] = false;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <qabstractproxymodel.h>
+#include <random>
+#include <vector>
+
+/**
+* Sorts and filters a SampleModel, repositioning only the rows reported as changed
+* Accepted rows are kept in an order statistics tree keyed on (sort value, source row)
+* so a changed row is found, moved and mapped in logarithmic time instead of re-sorting
+* Rows are filtered by state, inserted, removed and moved source rows become node inserts
+* and erases that renumber the following nodes, only source resets and layout changes rebuild
+*/
+class SampleSortProxy : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int sortRole READ sortRole WRITE setSortRole NOTIFY sortChanged)
+    Q_PROPERTY(Qt::SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortChanged)
+    Q_PROPERTY(int stateFilter READ stateFilter WRITE setStateFilter NOTIFY stateFilterChanged)
+
+public:
+    /**
+    * Filter accepting every state, bit n accepts SampleItem::State n
+    */
+    static const int AllStates = 0xFF;
+
+    SampleSortProxy(QObject* parent = nullptr);
+    virtual ~SampleSortProxy();
+
+    /**
+    * A sort role of -1 keeps the source order
+    */
+    int sortRole() const;
+    void setSortRole(int role);
+    Qt::SortOrder sortOrder() const;
+    void setSortOrder(Qt::SortOrder order);
+    int stateFilter() const;
+    void setStateFilter(int stateFilter);
+    Q_INVOKABLE void setStateAccepted(int state, bool accepted);
+
+    /**
+    * QAbstractProxyModel
+    */
+    virtual void setSourceModel(QAbstractItemModel* sourceModel) override;
+    virtual QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    virtual QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+    virtual QModelIndex index(int row, int column = 0, const QModelIndex& parent = QModelIndex()) const override;
+    virtual QModelIndex parent(const QModelIndex& child) const override;
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+signals:
+    void sortChanged();
+    void stateFilterChanged();
+
+private:
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onRowsAboutToBeMoved(const QModelIndex& sourceParent, int first, int last, const QModelIndex& destinationParent, int destination);
+    void onRowsMoved(const QModelIndex& sourceParent, int first, int last, const QModelIndex& destinationParent, int destination);
+    void onLayoutAboutToChange();
+    void onLayoutChanged();
+
+    /**
+    * Moves, inserts or removes a row whose key or state may have changed, proxy rows
+    * of rows that only need a dataChanged are collected in changedRows
+    */
+    void updateRow(int sourceRow, std::vector<int>& changedRows, const QVector<int>& roles);
+    void emitChangedRows(std::vector<int>& changedRows, const QVector<int>& roles);
+    void readRow(int sourceRow, int& key, bool& accepted) const;
+    void rebuild();
+
+    /**
+    * Source rows are inserted into or erased from the node arrays, the nodes after them
+    * are renumbered so their order in the tree is kept
+    */
+    void insertSourceRows(int first, int last);
+    void eraseSourceRows(int first, int last);
+    void insertAcceptedRows(int first, int last);
+    void removeAcceptedRows(int first, int last);
+    void shiftNodes(int first, int delta);
+
+    /**
+    * Treap over the source rows, each source row owns the node of the same index
+    */
+    bool nodeLess(int node, int key, int row) const;
+    int countLess(int key, int row) const;
+    int proxyRow(int sourceRow) const;
+    int select(int proxyRow) const;
+    int nodeSize(int node) const;
+    void updateSize(int node);
+    int computeSizes(int node);
+    void split(int node, int key, int row, int& left, int& right);
+    int merge(int left, int right);
+    void insertNode(int sourceRow);
+    void eraseNode(int sourceRow);
+
+    int m_sortRole = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+    int m_stateFilter = AllStates;
+    int m_resetDepth = 0;
+
+    std::vector<int> m_keys;
+    std::vector<bool> m_inTree;
+    std::vector<int> m_left;
+    std::vector<int> m_right;
+    std::vector<int> m_size;
+    std::vector<quint32> m_priority;
+    int m_root = -1;
+    std::mt19937 m_random;
+    std::vector<QMetaObject::Connection> m_sourceConnections;
+};
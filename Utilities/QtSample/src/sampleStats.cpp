@@ -0,0 +1,60 @@
+#include "sampleStats.h"
+
+void SampleStats::merge(const SampleStats& delta)
+{
+    m_rows += delta.m_rows;
+    for (int state = 0; state < StateCount; ++state)
+    {
+        m_stateCounts[state] += delta.m_stateCounts[state];
+    }
+    m_totalSteps += delta.m_totalSteps;
+    m_totalMaxSteps += delta.m_totalMaxSteps;
+    m_progressSum += delta.m_progressSum;
+    for (int bucket = 0; bucket < ProgressBuckets; ++bucket)
+    {
+        m_progressCounts[bucket] += delta.m_progressCounts[bucket];
+    }
+    m_revision += delta.m_revision;
+}
+
+void SampleStats::clear()
+{
+    const quint64 revision = m_revision;
+    *this = SampleStats();
+    m_revision = revision + 1;
+}
+
+quint64 SampleStats::revision() const
+{
+    return m_revision;
+}
+
+qint64 SampleStats::rows() const
+{
+    return m_rows;
+}
+
+qint64 SampleStats::stateCount(SampleItem::State state) const
+{
+    return state >= 0 && state < StateCount ? m_stateCounts[state] : 0;
+}
+
+qint64 SampleStats::totalSteps() const
+{
+    return m_totalSteps;
+}
+
+qint64 SampleStats::totalMaxSteps() const
+{
+    return m_totalMaxSteps;
+}
+
+double SampleStats::averageProgress() const
+{
+    return m_rows > 0 ? static_cast<double>(m_progressSum) / m_rows / ProgressScale : 0.0;
+}
+
+qint64 SampleStats::progressCount(int bucket) const
+{
+    return bucket >= 0 && bucket < ProgressBuckets ? m_progressCounts[bucket] : 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "sampleItem.h"
+#include <algorithm>
+
+/**
+* Aggregates over the rows of a store: counts per state, total steps and a histogram
+* of progress in tenths, kept current by adding and removing the values of each row
+* as it changes so no query ever has to visit the rows. Deltas of rows changed
+* elsewhere, such as on a tick thread, are gathered in their own instance and merged
+*/
+class SampleStats
+{
+public:
+    static const int StateCount = SampleItem::STOPPED + 1;
+    static const int ProgressBuckets = 10;
+
+    /**
+    * Progress of a row in thousandths, the average progress is kept exact by summing these
+    */
+    static const int ProgressScale = 1000;
+
+    void addRow(SampleItem::State state, int step, int maxSteps);
+    void removeRow(SampleItem::State state, int step, int maxSteps);
+    void changeRow(SampleItem::State oldState, int oldStep, int oldMaxSteps,
+        SampleItem::State state, int step, int maxSteps);
+    void merge(const SampleStats& delta);
+    void clear();
+
+    /**
+    * Increases with every change, so readers can tell whether anything changed since they last looked
+    */
+    quint64 revision() const;
+
+    qint64 rows() const;
+    qint64 stateCount(SampleItem::State state) const;
+    qint64 totalSteps() const;
+    qint64 totalMaxSteps() const;
+
+    /**
+    * Mean progress of the rows between 0 and 1
+    */
+    double averageProgress() const;
+
+    /**
+    * Rows whose progress falls within the tenth given by bucket, complete rows count towards the last
+    */
+    qint64 progressCount(int bucket) const;
+
+    static int progress(int step, int maxSteps);
+
+private:
+    void apply(SampleItem::State state, int step, int maxSteps, int sign);
+
+    qint64 m_rows = 0;
+    qint64 m_stateCounts[StateCount] = {};
+    qint64 m_totalSteps = 0;
+    qint64 m_totalMaxSteps = 0;
+    qint64 m_progressSum = 0;
+    qint64 m_progressCounts[ProgressBuckets] = {};
+    quint64 m_revision = 0;
+};
+
+//===========================================================================================================
+// Updates, inline as they sit on the tick path
+//===========================================================================================================
+
+inline int SampleStats::progress(int step, int maxSteps)
+{
+    if (maxSteps <= 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(static_cast<qint64>(std::min(std::max(step, 0), maxSteps)) * ProgressScale / maxSteps);
+}
+
+inline void SampleStats::apply(SampleItem::State state, int step, int maxSteps, int sign)
+{
+    const int rowProgress = progress(step, maxSteps);
+    m_rows += sign;
+    if (state >= 0 && state < StateCount)
+    {
+        m_stateCounts[state] += sign;
+    }
+    m_totalSteps += sign * static_cast<qint64>(step);
+    m_totalMaxSteps += sign * static_cast<qint64>(maxSteps);
+    m_progressSum += sign * rowProgress;
+    m_progressCounts[std::min(rowProgress * ProgressBuckets / ProgressScale, ProgressBuckets - 1)] += sign;
+    ++m_revision;
+}
+
+inline void SampleStats::addRow(SampleItem::State state, int step, int maxSteps)
+{
+    apply(state, step, maxSteps, 1);
+}
+
+inline void SampleStats::removeRow(SampleItem::State state, int step, int maxSteps)
+{
+    apply(state, step, maxSteps, -1);
+}
+
+inline void SampleStats::changeRow(SampleItem::State oldState, int oldStep, int oldMaxSteps,
+    SampleItem::State state, int step, int maxSteps)
+{
+    apply(oldState, oldStep, oldMaxSteps, -1);
+    apply(state, step, maxSteps, 1);
+}
@@ -0,0 +1,80 @@
+#include "sampleStore.h"
+#include "sampleSnapshot.h"
+
+void SampleStore::setRowChangedFn(onRowChangedFn changedFn)
+{
+    m_rowChangedFn = changedFn;
+}
+
+SampleItem* SampleStore::item(int row) const
+{
+    Q_UNUSED(row);
+    return nullptr;
+}
+
+int SampleStore::activeCount() const
+{
+    return count();
+}
+
+void SampleStore::tickActive(int first, int last, SampleDirtyTracker& dirtyRows)
+{
+    tick(first, last, dirtyRows);
+}
+
+void SampleStore::finishActive()
+{
+}
+
+void SampleStore::tickActiveRows(SampleDirtyTracker& dirtyRows)
+{
+    if (const int active = activeCount())
+    {
+        tickActive(0, active - 1, dirtyRows);
+        finishActive();
+    }
+}
+
+// Names are copied as the snapshot is closed once restoring is done
+void SampleStore::restore(const std::shared_ptr<SampleSnapshot>& snapshot)
+{
+    if (count() > 0)
+    {
+        remove(0, count());
+    }
+
+    const int rows = snapshot->count();
+    reserve(rows);
+    for (int row = 0; row < rows; ++row)
+    {
+        append(snapshot->name(row));
+        setMaxSteps(row, snapshot->maxSteps()[row]);
+        setState(row, static_cast<SampleItem::State>(snapshot->states()[row]));
+        setStep(row, snapshot->steps()[row]);
+        setStepRate(row, snapshot->stepRates()[row]);
+    }
+}
+
+void SampleStore::releaseSnapshot(const QString& path)
+{
+    Q_UNUSED(path);
+}
+
+const SampleStats& SampleStore::stats() const
+{
+    return m_stats;
+}
+
+void SampleStore::mergeStats(const SampleStats& delta)
+{
+    QMutexLocker lock(&m_statsMutex);
+    m_stats.merge(delta);
+}
+
+void SampleStore::rowChanged(int row, int changes) const
+{
+    if (m_rowChangedFn)
+    {
+        m_rowChangedFn(row, changes);
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "sampleItem.h"
+#include "sampleStats.h"
+#include <qmutex.h>
+#include <qstring.h>
+#include <functional>
+#include <memory>
+
+class SampleDirtyTracker;
+class SampleSnapshot;
+
+/**
+* Backing storage for the rows of a SampleModel
+* Mutators report changes through the row changed callback, ticking reports
+* changes to the given tracker so the model can batch its notifications
+*/
+class SampleStore
+{
+public:
+    typedef std::function<void(int row, int changes)> onRowChangedFn;
+
+    virtual ~SampleStore() = default;
+    void setRowChangedFn(onRowChangedFn changedFn);
+
+    virtual int count() const = 0;
+    virtual QString name(int row) const = 0;
+    virtual SampleItem::State state(int row) const = 0;
+    virtual int step(int row) const = 0;
+    virtual int maxSteps(int row) const = 0;
+    virtual int stepRate(int row) const = 0;
+
+    /**
+    * Identifier of the row, unique within the store and kept when rows move
+    */
+    virtual quint32 id(int row) const = 0;
+
+    virtual void setName(int row, const QString& name) = 0;
+    virtual void setState(int row, SampleItem::State state) = 0;
+    virtual void setStep(int row, int step) = 0;
+    virtual void setMaxSteps(int row, int maxSteps) = 0;
+    virtual void setStepRate(int row, int stepRate) = 0;
+
+    virtual void reserve(int count) = 0;
+    virtual void append(const QString& name) = 0;
+    virtual void remove(int row, int count) = 0;
+
+    /**
+    * Moves count rows starting at from so the first of them ends up at row to
+    */
+    virtual void move(int from, int count, int to) = 0;
+
+    /**
+    * Steps the rows from first to last inclusive
+    */
+    virtual void tick(int first, int last, SampleDirtyTracker& dirtyRows) = 0;
+
+    /**
+    * Active Set
+    * Stores may keep their stepping rows in an active set, updated as states change,
+    * so ticking only visits those rows. Stores without one treat every row as active
+    * tickActive steps the entries first to last of the set, disjoint entries may be
+    * stepped concurrently, finishActive then drops the rows that completed
+    */
+    virtual int activeCount() const;
+    virtual void tickActive(int first, int last, SampleDirtyTracker& dirtyRows);
+    virtual void finishActive();
+
+    /**
+    * Steps every row of the active set
+    */
+    void tickActiveRows(SampleDirtyTracker& dirtyRows);
+
+    /**
+    * Returns the object backing the row if the store uses them
+    */
+    virtual SampleItem* item(int row) const;
+
+    /**
+    * Replaces every row with a copy of the rows of the snapshot, a store that keeps
+    * reading part of it from the mapping keeps it open
+    */
+    virtual void restore(const std::shared_ptr<SampleSnapshot>& snapshot);
+
+    /**
+    * Copies whatever the store still reads from a snapshot mapped from path and
+    * closes it, so the file can be replaced, stores that copy on restore have nothing to do
+    */
+    virtual void releaseSnapshot(const QString& path);
+
+    /**
+    * Statistics
+    * Aggregates of every row, stores update them along with each row before reporting the change
+    * Concurrent tickActive calls gather theirs in a delta of their own merged once they are done
+    */
+    const SampleStats& stats() const;
+
+protected:
+    void rowChanged(int row, int changes) const;
+    void mergeStats(const SampleStats& delta);
+
+    SampleStats m_stats;
+
+private:
+    QMutex m_statsMutex;
+    onRowChangedFn m_rowChangedFn = nullptr;
+};
@@ -0,0 +1,80 @@
+#include "sampleSummary.h"
+
+SampleSummary::SampleSummary(const SampleStats& stats, QObject* parent)
+    : QObject(parent)
+    , m_stats(stats)
+    , m_revision(stats.revision())
+{
+}
+
+SampleSummary::~SampleSummary() = default;
+
+void SampleSummary::update()
+{
+    if (m_revision != m_stats.revision())
+    {
+        m_revision = m_stats.revision();
+        emit changed();
+    }
+}
+
+qint64 SampleSummary::rows() const
+{
+    return m_stats.rows();
+}
+
+qint64 SampleSummary::noneCount() const
+{
+    return m_stats.stateCount(SampleItem::NONE);
+}
+
+qint64 SampleSummary::steppingCount() const
+{
+    return m_stats.stateCount(SampleItem::STEPPING);
+}
+
+qint64 SampleSummary::pausedCount() const
+{
+    return m_stats.stateCount(SampleItem::PAUSED);
+}
+
+qint64 SampleSummary::completeCount() const
+{
+    return m_stats.stateCount(SampleItem::COMPLETE);
+}
+
+qint64 SampleSummary::stoppedCount() const
+{
+    return m_stats.stateCount(SampleItem::STOPPED);
+}
+
+qint64 SampleSummary::totalSteps() const
+{
+    return m_stats.totalSteps();
+}
+
+qint64 SampleSummary::totalMaxSteps() const
+{
+    return m_stats.totalMaxSteps();
+}
+
+double SampleSummary::averageProgress() const
+{
+    return m_stats.averageProgress();
+}
+
+QVariantList SampleSummary::progressHistogram() const
+{
+    QVariantList counts;
+    counts.reserve(SampleStats::ProgressBuckets);
+    for (int bucket = 0; bucket < SampleStats::ProgressBuckets; ++bucket)
+    {
+        counts.append(m_stats.progressCount(bucket));
+    }
+    return counts;
+}
+
+qint64 SampleSummary::stateCount(int state) const
+{
+    return m_stats.stateCount(static_cast<SampleItem::State>(state));
+}
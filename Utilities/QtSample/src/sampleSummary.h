@@ -0,0 +1,59 @@
+#pragma once
+#include "sampleStats.h"
+#include <qobject.h>
+#include <qvariant.h>
+
+/**
+* Exposes the statistics of a store to QML for dashboards and summaries
+* Every property reads the maintained aggregates, so binding to them costs the same
+* for any number of rows. changed is emitted by update, which the model calls once
+* after each batch of changes rather than for every row
+*/
+class SampleSummary : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qint64 rows READ rows NOTIFY changed)
+    Q_PROPERTY(qint64 noneCount READ noneCount NOTIFY changed)
+    Q_PROPERTY(qint64 steppingCount READ steppingCount NOTIFY changed)
+    Q_PROPERTY(qint64 pausedCount READ pausedCount NOTIFY changed)
+    Q_PROPERTY(qint64 completeCount READ completeCount NOTIFY changed)
+    Q_PROPERTY(qint64 stoppedCount READ stoppedCount NOTIFY changed)
+    Q_PROPERTY(qint64 totalSteps READ totalSteps NOTIFY changed)
+    Q_PROPERTY(qint64 totalMaxSteps READ totalMaxSteps NOTIFY changed)
+    Q_PROPERTY(double averageProgress READ averageProgress NOTIFY changed)
+    Q_PROPERTY(QVariantList progressHistogram READ progressHistogram NOTIFY changed)
+
+public:
+    SampleSummary(const SampleStats& stats, QObject* parent = nullptr);
+    virtual ~SampleSummary();
+
+    /**
+    * Emits changed if the statistics changed since the last update
+    */
+    void update();
+
+    qint64 rows() const;
+    qint64 noneCount() const;
+    qint64 steppingCount() const;
+    qint64 pausedCount() const;
+    qint64 completeCount() const;
+    qint64 stoppedCount() const;
+    qint64 totalSteps() const;
+    qint64 totalMaxSteps() const;
+    double averageProgress() const;
+
+    /**
+    * Rows per tenth of progress, complete rows count towards the last
+    */
+    QVariantList progressHistogram() const;
+
+    Q_INVOKABLE qint64 stateCount(int state) const;
+
+signals:
+    void changed();
+
+private:
+    const SampleStats& m_stats;
+    quint64 m_revision = 0;
+};
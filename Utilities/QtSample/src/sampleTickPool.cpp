@@ -0,0 +1,142 @@
+#include "sampleTickPool.h"
+#include "sampleStore.h"
+#include "sampleTrace.h"
+#include <qthread.h>
+#include <algorithm>
+
+class SampleTickPool::Worker : public QThread
+{
+public:
+    Worker(SampleTickPool& pool)
+        : m_pool(pool)
+    {
+    }
+
+protected:
+    virtual void run() override
+    {
+        m_pool.workerLoop();
+    }
+
+private:
+    SampleTickPool& m_pool;
+};
+
+// The calling thread also processes chunks, so only threadCount - 1 workers are needed
+SampleTickPool::SampleTickPool(int threadCount)
+{
+    for (int i = 1; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(new Worker(*this));
+        m_workers.back()->start();
+    }
+}
+
+SampleTickPool::~SampleTickPool()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_quit = true;
+        m_jobReady.wakeAll();
+    }
+
+    for (auto& worker : m_workers)
+    {
+        worker->wait();
+    }
+}
+
+int SampleTickPool::threadCount() const
+{
+    return static_cast<int>(m_workers.size()) + 1;
+}
+
+void SampleTickPool::tick(SampleStore& store, SampleDirtyTracker& dirtyRows)
+{
+    const int rows = store.activeCount();
+    const int chunkCount = (rows + ChunkSize - 1) / ChunkSize;
+    if (chunkCount <= 1 || m_workers.empty())
+    {
+        store.tickActiveRows(dirtyRows);
+        return;
+    }
+
+    if (static_cast<int>(m_chunkDirtyRows.size()) < chunkCount)
+    {
+        m_chunkDirtyRows.resize(chunkCount);
+    }
+
+    m_store = &store;
+    m_rows = rows;
+    m_chunkCount = chunkCount;
+    m_nextChunk.store(0);
+    {
+        QMutexLocker lock(&m_mutex);
+        m_busyWorkers = static_cast<int>(m_workers.size());
+        ++m_generation;
+        m_jobReady.wakeAll();
+    }
+
+    runChunks();
+
+    {
+        QMutexLocker lock(&m_mutex);
+        while (m_busyWorkers > 0)
+        {
+            m_jobDone.wait(&m_mutex);
+        }
+    }
+
+    // The active set is unordered, the tracker sorts the merged rows when flushed
+    for (int chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        dirtyRows.merge(m_chunkDirtyRows[chunk]);
+    }
+    store.finishActive();
+    m_store = nullptr;
+}
+
+void SampleTickPool::workerLoop()
+{
+    quint64 generation = 0;
+    for (;;)
+    {
+        {
+            QMutexLocker lock(&m_mutex);
+            while (!m_quit && m_generation == generation)
+            {
+                m_jobReady.wait(&m_mutex);
+            }
+            if (m_quit)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        runChunks();
+
+        QMutexLocker lock(&m_mutex);
+        if (--m_busyWorkers == 0)
+        {
+            m_jobDone.wakeAll();
+        }
+    }
+}
+
+void SampleTickPool::runChunks()
+{
+    for (;;)
+    {
+        const int chunk = m_nextChunk.fetch_add(1);
+        if (chunk >= m_chunkCount)
+        {
+            return;
+        }
+
+        const int first = chunk * ChunkSize;
+        const int last = std::min(first + ChunkSize, m_rows) - 1;
+        SAMPLE_TRACE_SCOPE("tick", "chunk");
+        m_store->tickActive(first, last, m_chunkDirtyRows[chunk]);
+    }
+}
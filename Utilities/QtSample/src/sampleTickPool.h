@@ -0,0 +1,46 @@
+#pragma once
+#include "sampleDirtyTracker.h"
+#include <qmutex.h>
+#include <qwaitcondition.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SampleStore;
+
+/**
+* Ticks the active rows of a store across several threads
+* The active set is split into fixed size chunks which idle threads claim until none are
+* left, each chunk records its own changed rows which are merged afterwards
+*/
+class SampleTickPool
+{
+public:
+    static const int ChunkSize = 16384;
+
+    explicit SampleTickPool(int threadCount);
+    ~SampleTickPool();
+
+    int threadCount() const;
+    void tick(SampleStore& store, SampleDirtyTracker& dirtyRows);
+
+private:
+    class Worker;
+
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    QMutex m_mutex;
+    QWaitCondition m_jobReady;
+    QWaitCondition m_jobDone;
+    quint64 m_generation = 0;
+    int m_busyWorkers = 0;
+    bool m_quit = false;
+
+    SampleStore* m_store = nullptr;
+    int m_rows = 0;
+    int m_chunkCount = 0;
+    std::atomic<int> m_nextChunk{ 0 };
+    std::vector<SampleDirtyTracker> m_chunkDirtyRows;
+};
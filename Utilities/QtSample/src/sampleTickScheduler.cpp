@@ -0,0 +1,107 @@
+#include "sampleTickScheduler.h"
+#include "sampleModel.h"
+#include <qquickwindow.h>
+
+SampleTickScheduler::SampleTickScheduler(SampleModel& model, QObject* parent)
+    : QObject(parent)
+    , m_model(model)
+{
+    m_timer.setInterval(10);
+    connect(&m_timer, &QTimer::timeout, this, &SampleTickScheduler::tick);
+    connect(&m_model, &SampleModel::steppingChanged, this, &SampleTickScheduler::onSteppingChanged);
+    schedule();
+}
+
+SampleTickScheduler::~SampleTickScheduler() = default;
+
+void SampleTickScheduler::setInterval(int intervalMs)
+{
+    m_timer.setInterval(intervalMs);
+}
+
+int SampleTickScheduler::interval() const
+{
+    return m_timer.interval();
+}
+
+void SampleTickScheduler::setFrameWindow(QQuickWindow* window)
+{
+    disconnect(m_frameConnection);
+    m_window = window;
+    if (window)
+    {
+        // frameSwapped comes from the render thread with the threaded render loop,
+        // queueing it ticks on this thread between frames instead of during one
+        m_frameConnection = connect(window, &QQuickWindow::frameSwapped,
+            this, &SampleTickScheduler::onFrameSwapped, Qt::QueuedConnection);
+    }
+    schedule();
+}
+
+SampleTickScheduler::Mode SampleTickScheduler::mode() const
+{
+    return m_window ? FrameMode : TimerMode;
+}
+
+bool SampleTickScheduler::isActive() const
+{
+    return m_model.isStepping();
+}
+
+quint64 SampleTickScheduler::tickCount() const
+{
+    return m_tickCount;
+}
+
+quint64 SampleTickScheduler::idleTickCount() const
+{
+    return m_idleTickCount;
+}
+
+void SampleTickScheduler::onSteppingChanged(bool stepping)
+{
+    Q_UNUSED(stepping);
+    schedule();
+}
+
+void SampleTickScheduler::onFrameSwapped()
+{
+    if (m_model.isStepping())
+    {
+        tick();
+        schedule();
+    }
+}
+
+void SampleTickScheduler::tick()
+{
+    m_model.tick();
+    ++m_tickCount;
+    if (!m_model.isStepping())
+    {
+        ++m_idleTickCount;
+    }
+    emit ticked();
+}
+
+// Runs the timer or requests a frame while items step, otherwise nothing wakes up
+void SampleTickScheduler::schedule()
+{
+    const bool stepping = m_model.isStepping();
+    if (mode() == FrameMode)
+    {
+        m_timer.stop();
+        if (stepping)
+        {
+            m_window->update();
+        }
+    }
+    else if (stepping && !m_timer.isActive())
+    {
+        m_timer.start();
+    }
+    else if (!stepping)
+    {
+        m_timer.stop();
+    }
+}
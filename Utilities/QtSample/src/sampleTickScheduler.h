@@ -0,0 +1,60 @@
+#pragma once
+#include <qobject.h>
+#include <qpointer.h>
+#include <qtimer.h>
+
+class SampleModel;
+class QQuickWindow;
+
+/**
+* Drives SampleModel::tick only while items are stepping
+* Timer mode ticks at a fixed interval, frame mode ticks once per frame of a
+* window and requests the next frame for as long as items keep stepping,
+* so it pauses along with rendering while the window is hidden
+*/
+class SampleTickScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode
+    {
+        TimerMode,
+        FrameMode
+    };
+
+    SampleTickScheduler(SampleModel& model, QObject* parent = nullptr);
+    virtual ~SampleTickScheduler();
+
+    void setInterval(int intervalMs);
+    int interval() const;
+
+    /**
+    * Ticks in step with the frames of window, or on the timer if window is null
+    */
+    void setFrameWindow(QQuickWindow* window);
+    Mode mode() const;
+    bool isActive() const;
+
+    /**
+    * Ticks run so far, idle ticks are the ones that found nothing left to step
+    */
+    quint64 tickCount() const;
+    quint64 idleTickCount() const;
+
+signals:
+    void ticked();
+
+private:
+    void onSteppingChanged(bool stepping);
+    void onFrameSwapped();
+    void tick();
+    void schedule();
+
+    SampleModel& m_model;
+    QTimer m_timer;
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    quint64 m_tickCount = 0;
+    quint64 m_idleTickCount = 0;
+};
@@ -0,0 +1,294 @@
+#include "sampleTrace.h"
+#include <qcoreapplication.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qmutex.h>
+#include <qquickwindow.h>
+#include <qthread.h>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* category;
+        const char* name;
+        qint64 start;
+        qint64 value;
+        char phase;
+    };
+
+    // Only the owning thread writes to a buffer, written is published after each event
+    struct TraceBuffer
+    {
+        std::vector<TraceEvent> events;
+        std::atomic<quint64> written{ 0 };
+        int threadId = 0;
+        int generation = 0;
+        QString threadName;
+    };
+
+    // Buffers outlive their threads so events of finished threads are still dumped,
+    // buffers of a previous start are retired but never freed nor resized
+    struct TraceState
+    {
+        QMutex mutex;
+        std::vector<std::unique_ptr<TraceBuffer>> buffers;
+        std::vector<std::unique_ptr<TraceBuffer>> retired;
+        std::atomic<int> generation{ 0 };
+        QElapsedTimer clock;
+        int capacity = SampleTrace::DefaultCapacity;
+    };
+
+    TraceState& traceState()
+    {
+        static TraceState state;
+        return state;
+    }
+
+    thread_local TraceBuffer* t_buffer = nullptr;
+
+    TraceBuffer* createThreadBuffer()
+    {
+        TraceState& state = traceState();
+        QMutexLocker lock(&state.mutex);
+        std::unique_ptr<TraceBuffer> buffer(new TraceBuffer);
+        buffer->events.resize(state.capacity);
+        buffer->threadId = static_cast<int>(state.buffers.size()) + 1;
+        buffer->generation = state.generation.load(std::memory_order_relaxed);
+
+        // Qt's own threads such as QSGRenderThread are only told apart by their class name
+        QThread* thread = QThread::currentThread();
+        const QCoreApplication* app = QCoreApplication::instance();
+        buffer->threadName = app && app->thread() == thread ? QString("main") :
+            !thread->objectName().isEmpty() ? thread->objectName() :
+            QString(thread->metaObject()->className());
+
+        t_buffer = buffer.get();
+        state.buffers.push_back(std::move(buffer));
+        return t_buffer;
+    }
+
+    QByteArray metadataJson(const char* name, int threadId, const QString& value)
+    {
+        QJsonObject args;
+        args["name"] = value;
+        QJsonObject event;
+        event["ph"] = QString("M");
+        event["name"] = QString(name);
+        event["pid"] = 1;
+        event["tid"] = threadId;
+        event["args"] = args;
+        return QJsonDocument(event).toJson(QJsonDocument::Compact);
+    }
+
+    // Events are written by hand, a QJsonDocument of a full capture would be several times its size
+    void appendEventJson(QByteArray& json, const TraceEvent& event, int threadId)
+    {
+        json += "{\"ph\":\"";
+        json += event.phase;
+        json += "\",\"cat\":\"";
+        json += event.category;
+        json += "\",\"name\":\"";
+        json += event.name;
+        json += "\",\"pid\":1,\"tid\":";
+        json += QByteArray::number(threadId);
+        json += ",\"ts\":";
+        json += QByteArray::number(event.start / 1e3, 'f', 3);
+        switch (event.phase)
+        {
+        case 'X':
+            json += ",\"dur\":";
+            json += QByteArray::number(event.value / 1e3, 'f', 3);
+            break;
+        case 'C':
+            json += ",\"args\":{\"value\":";
+            json += QByteArray::number(event.value);
+            json += "}";
+            break;
+        case 'i':
+            json += ",\"s\":\"t\"";
+            break;
+        }
+        json += "}";
+    }
+}
+
+std::atomic<bool> SampleTrace::s_enabled{ false };
+
+bool SampleTrace::isAvailable()
+{
+#ifdef SAMPLE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SampleTrace::start(int capacity)
+{
+    if (!isAvailable())
+    {
+        return;
+    }
+
+    stop();
+    TraceState& state = traceState();
+    QMutexLocker lock(&state.mutex);
+    state.capacity = std::max(capacity, 1);
+    std::move(state.buffers.begin(), state.buffers.end(), std::back_inserter(state.retired));
+    state.buffers.clear();
+    state.generation.fetch_add(1, std::memory_order_release);
+    state.clock.start();
+    s_enabled.store(true);
+}
+
+void SampleTrace::stop()
+{
+    s_enabled.store(false);
+}
+
+qint64 SampleTrace::now()
+{
+    return traceState().clock.nsecsElapsed();
+}
+
+void SampleTrace::complete(const char* category, const char* name, qint64 start)
+{
+    if (isEnabled())
+    {
+        record(category, name, 'X', start, now() - start);
+    }
+}
+
+void SampleTrace::begin(const char* category, const char* name)
+{
+    if (isEnabled())
+    {
+        record(category, name, 'B', now(), 0);
+    }
+}
+
+void SampleTrace::end(const char* category, const char* name)
+{
+    if (isEnabled())
+    {
+        record(category, name, 'E', now(), 0);
+    }
+}
+
+void SampleTrace::instant(const char* category, const char* name)
+{
+    if (isEnabled())
+    {
+        record(category, name, 'i', now(), 0);
+    }
+}
+
+void SampleTrace::counter(const char* category, const char* name, qint64 value)
+{
+    if (isEnabled())
+    {
+        record(category, name, 'C', now(), value);
+    }
+}
+
+void SampleTrace::traceWindow(QQuickWindow* window)
+{
+#ifdef SAMPLE_TRACE
+    // Sync, render and frameSwapped are emitted on the render thread with the threaded render loop,
+    // direct connections record them there instead of when the main thread gets around to it
+    QObject::connect(window, &QQuickWindow::beforeSynchronizing, window, []() { begin("scenegraph", "sync"); }, Qt::DirectConnection);
+    QObject::connect(window, &QQuickWindow::afterSynchronizing, window, []() { end("scenegraph", "sync"); }, Qt::DirectConnection);
+    QObject::connect(window, &QQuickWindow::beforeRendering, window, []() { begin("scenegraph", "render"); }, Qt::DirectConnection);
+    QObject::connect(window, &QQuickWindow::afterRendering, window, []() { end("scenegraph", "render"); }, Qt::DirectConnection);
+    QObject::connect(window, &QQuickWindow::frameSwapped, window, []() { instant("scenegraph", "frameSwapped"); }, Qt::DirectConnection);
+    QObject::connect(window, &QQuickWindow::afterAnimating, window, []() { instant("qml", "animate"); }, Qt::DirectConnection);
+#else
+    Q_UNUSED(window);
+#endif
+}
+
+quint64 SampleTrace::eventCount()
+{
+    TraceState& state = traceState();
+    QMutexLocker lock(&state.mutex);
+    quint64 count = 0;
+    for (const auto& buffer : state.buffers)
+    {
+        count += std::min<quint64>(buffer->written.load(), buffer->events.size());
+    }
+    return count;
+}
+
+quint64 SampleTrace::droppedCount()
+{
+    TraceState& state = traceState();
+    QMutexLocker lock(&state.mutex);
+    quint64 count = 0;
+    for (const auto& buffer : state.buffers)
+    {
+        const quint64 written = buffer->written.load();
+        count += written > buffer->events.size() ? written - buffer->events.size() : 0;
+    }
+    return count;
+}
+
+bool SampleTrace::dumpJson(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    TraceState& state = traceState();
+    QMutexLocker lock(&state.mutex);
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += metadataJson("process_name", 0, QCoreApplication::applicationName());
+    for (const auto& buffer : state.buffers)
+    {
+        json += ",\n";
+        json += metadataJson("thread_name", buffer->threadId, buffer->threadName);
+
+        // Once a buffer wrapped around its oldest event is the one that is overwritten next
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 size = buffer->events.size();
+        for (quint64 i = written > size ? written - size : 0; i < written; ++i)
+        {
+            json += ",\n";
+            appendEventJson(json, buffer->events[i % size], buffer->threadId);
+        }
+
+        // Keep the chunks written to the file small for long captures
+        if (json.size() > (1 << 20))
+        {
+            if (file.write(json) < 0)
+            {
+                return false;
+            }
+            json.clear();
+        }
+    }
+    json += "\n]}\n";
+    return file.write(json) >= 0;
+}
+
+// A thread that still holds a buffer of a previous start finishes its event there and
+// picks up a new buffer on its next one
+void SampleTrace::record(const char* category, const char* name, char phase, qint64 start, qint64 value)
+{
+    TraceBuffer* buffer = t_buffer;
+    if (!buffer || buffer->generation != traceState().generation.load(std::memory_order_acquire))
+    {
+        buffer = createThreadBuffer();
+    }
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[index % buffer->events.size()] = { category, name, start, value, phase };
+    buffer->written.store(index + 1, std::memory_order_release);
+}
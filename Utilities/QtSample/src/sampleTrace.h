@@ -0,0 +1,115 @@
+#pragma once
+#include <qglobal.h>
+#include <qstring.h>
+#include <atomic>
+
+class QQuickWindow;
+
+/**
+* Trace sites are compiled in with SAMPLE_TRACE, see the SAMPLE_TRACE
+* CMake option, so a build without it pays nothing for them
+*/
+#ifdef SAMPLE_TRACE
+#define SAMPLE_TRACE_JOIN_(a, b) a##b
+#define SAMPLE_TRACE_JOIN(a, b) SAMPLE_TRACE_JOIN_(a, b)
+#define SAMPLE_TRACE_SCOPE(category, name) SampleTraceScope SAMPLE_TRACE_JOIN(sampleTraceScope, __LINE__)(category, name)
+#define SAMPLE_TRACE_INSTANT(category, name) SampleTrace::instant(category, name)
+#define SAMPLE_TRACE_COUNTER(category, name, value) SampleTrace::counter(category, name, value)
+#else
+#define SAMPLE_TRACE_SCOPE(category, name)
+#define SAMPLE_TRACE_INSTANT(category, name)
+#define SAMPLE_TRACE_COUNTER(category, name, value)
+#endif
+
+/**
+* Timeline of events in the Chrome trace event format, chrome://tracing and ui.perfetto.dev open the dump
+* Each thread records into its own fixed size ring buffer without locking, once it is full the oldest
+* events are overwritten so a dump holds the last events of every thread. Categories and names are
+* stored as pointers and have to be string literals
+*/
+class SampleTrace
+{
+public:
+    static const int DefaultCapacity = 1 << 16;
+
+    /**
+    * True when built with SAMPLE_TRACE, otherwise nothing is ever recorded
+    */
+    static bool isAvailable();
+
+    /**
+    * Starts recording into fresh buffers, capacity is the number of events kept per thread
+    * Threads switch to a new buffer on their next event, the previous ones are left alone
+    * since a thread may still be writing to them. Start, stop and dump are meant to be called
+    * from the main thread
+    */
+    static void start(int capacity = DefaultCapacity);
+    static void stop();
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * Nanoseconds since the trace started
+    */
+    static qint64 now();
+
+    static void complete(const char* category, const char* name, qint64 start);
+    static void begin(const char* category, const char* name);
+    static void end(const char* category, const char* name);
+    static void instant(const char* category, const char* name);
+    static void counter(const char* category, const char* name, qint64 value);
+
+    /**
+    * Records the scene graph sync and render passes of window as well as its frame swaps
+    * and animation ticks, the render thread ones are recorded on the render thread
+    */
+    static void traceWindow(QQuickWindow* window);
+
+    /**
+    * Events currently held and events overwritten since the trace started
+    */
+    static quint64 eventCount();
+    static quint64 droppedCount();
+
+    /**
+    * Writes the buffered events of every thread, stop first so no thread is overwriting
+    * the events being written
+    */
+    static bool dumpJson(const QString& path);
+
+private:
+    static void record(const char* category, const char* name, char phase, qint64 start, qint64 value);
+
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+* Records a complete event spanning its lifetime, use SAMPLE_TRACE_SCOPE
+*/
+class SampleTraceScope
+{
+public:
+    SampleTraceScope(const char* category, const char* name)
+        : m_category(category)
+        , m_name(name)
+        , m_start(SampleTrace::isEnabled() ? SampleTrace::now() : -1)
+    {
+    }
+
+    ~SampleTraceScope()
+    {
+        if (m_start >= 0)
+        {
+            SampleTrace::complete(m_category, m_name, m_start);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(SampleTraceScope)
+
+    const char* m_category;
+    const char* m_name;
+    qint64 m_start;
+};
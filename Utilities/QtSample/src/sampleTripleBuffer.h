@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+
+/**
+* Lock-free single producer, single consumer handoff of the latest value
+* The writer fills the write buffer then publishes it, the reader picks up the
+* most recently published buffer and never waits on the writer
+*/
+template <typename T>
+class SampleTripleBuffer
+{
+public:
+    T& writeBuffer()
+    {
+        return m_buffers[m_writeIndex];
+    }
+
+    /**
+    * Returns true if the reader picked up the previously published buffer,
+    * false if it was replaced before the reader got to it
+    */
+    bool publish()
+    {
+        const int previous = m_middle.exchange(m_writeIndex | FreshBit, std::memory_order_acq_rel);
+        m_writeIndex = previous & IndexMask;
+        return !(previous & FreshBit);
+    }
+
+    /**
+    * Swaps in the latest published buffer, returns false if nothing new was published
+    */
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FreshBit))
+        {
+            return false;
+        }
+        const int previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previous & IndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const
+    {
+        return m_buffers[m_readIndex];
+    }
+
+private:
+    static const int IndexMask = 0x3;
+    static const int FreshBit = 0x4;
+
+    T m_buffers[3];
+    std::atomic<int> m_middle{ 1 };
+    int m_writeIndex = 0;
+    int m_readIndex = 2;
+};
@@ -0,0 +1,141 @@
+#include "sampleValueList.h"
+
+SampleValueList::SampleValueList(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+SampleValueList::~SampleValueList() = default;
+
+int SampleValueList::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant SampleValueList::data(const QModelIndex& index, int role) const
+{
+    if (index.row() < 0 || index.row() >= count() || (role != ValueRole && role != Qt::DisplayRole))
+    {
+        return QVariant();
+    }
+    return valueAt(index.row());
+}
+
+QHash<int, QByteArray> SampleValueList::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[ValueRole] = "value";
+    return roles;
+}
+
+void SampleValueList::beginAppend(int count)
+{
+    beginInsertRows(QModelIndex(), this->count(), this->count() + count - 1);
+}
+
+void SampleValueList::endAppend()
+{
+    endInsertRows();
+    emit countChanged();
+}
+
+void SampleValueList::beginAssign()
+{
+    beginResetModel();
+}
+
+void SampleValueList::endAssign()
+{
+    endResetModel();
+    emit countChanged();
+}
+
+//===========================================================================================================
+// Int List
+//===========================================================================================================
+
+SampleIntList::SampleIntList(QObject* parent)
+    : SampleValueList(parent)
+{
+}
+
+SampleIntList::~SampleIntList() = default;
+
+int SampleIntList::count() const
+{
+    return static_cast<int>(m_values.size());
+}
+
+int SampleIntList::at(int index) const
+{
+    return index >= 0 && index < count() ? m_values[index] : 0;
+}
+
+void SampleIntList::append(int value)
+{
+    beginAppend(1);
+    m_values.push_back(value);
+    endAppend();
+}
+
+void SampleIntList::assign(std::vector<int> values)
+{
+    beginAssign();
+    m_values.swap(values);
+    endAssign();
+}
+
+const std::vector<int>& SampleIntList::values() const
+{
+    return m_values;
+}
+
+QVariant SampleIntList::valueAt(int index) const
+{
+    return m_values[index];
+}
+
+//===========================================================================================================
+// Color List
+//===========================================================================================================
+
+SampleColorList::SampleColorList(QObject* parent)
+    : SampleValueList(parent)
+{
+}
+
+SampleColorList::~SampleColorList() = default;
+
+int SampleColorList::count() const
+{
+    return static_cast<int>(m_values.size());
+}
+
+QColor SampleColorList::at(int index) const
+{
+    return index >= 0 && index < count() ? m_values[index] : QColor();
+}
+
+void SampleColorList::append(const QColor& value)
+{
+    beginAppend(1);
+    m_values.push_back(value);
+    endAppend();
+}
+
+void SampleColorList::assign(std::vector<QColor> values)
+{
+    beginAssign();
+    m_values.swap(values);
+    endAssign();
+}
+
+const std::vector<QColor>& SampleColorList::values() const
+{
+    return m_values;
+}
+
+QVariant SampleColorList::valueAt(int index) const
+{
+    return m_values[index];
+}
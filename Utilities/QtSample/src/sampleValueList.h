@@ -0,0 +1,95 @@
+#pragma once
+#include <qabstractitemmodel.h>
+#include <qcolor.h>
+#include <vector>
+
+/**
+* Read only list exposed to QML without converting it
+* A QList or QVariantList property is copied into a new JS array on every access,
+* these lists hand out one element at a time through at() or to views through ValueRole
+*/
+class SampleValueList : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles
+    {
+        ValueRole = Qt::UserRole + 1
+    };
+
+    SampleValueList(QObject* parent = nullptr);
+    virtual ~SampleValueList();
+
+    virtual int count() const = 0;
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+
+protected:
+    virtual QVariant valueAt(int index) const = 0;
+
+    /**
+    * Wrap changes to the values so views and count bindings follow them
+    */
+    void beginAppend(int count);
+    void endAppend();
+    void beginAssign();
+    void endAssign();
+};
+
+/**
+* List of ints, at() returns 0 outside of the list
+*/
+class SampleIntList : public SampleValueList
+{
+    Q_OBJECT
+
+public:
+    SampleIntList(QObject* parent = nullptr);
+    virtual ~SampleIntList();
+
+    virtual int count() const override;
+    Q_INVOKABLE int at(int index) const;
+
+    void append(int value);
+    void assign(std::vector<int> values);
+    const std::vector<int>& values() const;
+
+protected:
+    virtual QVariant valueAt(int index) const override;
+
+private:
+    std::vector<int> m_values;
+};
+
+/**
+* List of colors, at() returns an invalid color outside of the list
+*/
+class SampleColorList : public SampleValueList
+{
+    Q_OBJECT
+
+public:
+    SampleColorList(QObject* parent = nullptr);
+    virtual ~SampleColorList();
+
+    virtual int count() const override;
+    Q_INVOKABLE QColor at(int index) const;
+
+    void append(const QColor& value);
+    void assign(std::vector<QColor> values);
+    const std::vector<QColor>& values() const;
+
+protected:
+    virtual QVariant valueAt(int index) const override;
+
+private:
+    std::vector<QColor> m_values;
+};
@@ -0,0 +1,257 @@
+#include "sampleWindows.h"
+#include <qquickview.h>
+#include <qquickitem.h>
+#include <qqmlengine.h>
+#include <qqmlcomponent.h>
+#include <qqmlincubator.h>
+#include <qstringlist.h>
+#include <qtimer.h>
+
+namespace
+{
+    QString errorString(const QList<QQmlError>& errors)
+    {
+        QStringList lines;
+        for (const auto& error : errors)
+        {
+            lines.append(error.toString());
+        }
+        return lines.join("\n");
+    }
+}
+
+//=====================================================================================================================
+// Incubator
+//=====================================================================================================================
+
+// Hands the finished root object back to SampleWindows
+class SampleWindows::Incubator : public QQmlIncubator
+{
+public:
+    Incubator(SampleWindows& windows, Window window)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_windows(windows)
+        , m_window(window)
+    {
+    }
+
+protected:
+    virtual void statusChanged(Status status) override
+    {
+        if (status == QQmlIncubator::Ready)
+        {
+            m_windows.onIncubated(m_window);
+        }
+        else if (status == QQmlIncubator::Error)
+        {
+            m_windows.onFailed(m_window, errorString(errors()));
+        }
+    }
+
+private:
+    SampleWindows& m_windows;
+    Window m_window;
+};
+
+//=====================================================================================================================
+// SampleWindows
+//=====================================================================================================================
+
+SampleWindows::SampleWindows(QQuickView& mainView, const QElapsedTimer& startupTimer, QObject* parent)
+    : QObject(parent)
+    , m_mainView(mainView)
+    , m_startupTimer(startupTimer)
+    , m_firstFrameNs(-1)
+{
+    m_entries[PaletteWindow].title = "Qt Palette";
+    m_entries[PaletteWindow].source = QUrl("qrc:/palette.qml");
+    m_entries[PickerWindow].title = "Qt Picker";
+    m_entries[PickerWindow].source = QUrl("qrc:/picker.qml");
+
+    // frameSwapped comes from the render thread with the threaded render loop, the time is taken
+    // there so it is not delayed by a busy main thread, which then picks it up from a queued call
+    m_frameConnection = connect(&m_mainView, &QQuickWindow::frameSwapped, this, [this]()
+    {
+        qint64 unset = -1;
+        m_firstFrameNs.compare_exchange_strong(unset, m_startupTimer.nsecsElapsed());
+    }, Qt::DirectConnection);
+    m_firstFrameConnection = connect(&m_mainView, &QQuickWindow::frameSwapped,
+        this, &SampleWindows::onFirstFrame, Qt::QueuedConnection);
+}
+
+// Incubators and windows sharing the main view's engine go before it does
+SampleWindows::~SampleWindows() = default;
+
+void SampleWindows::setCreation(Creation creation)
+{
+    m_creation = creation;
+}
+
+SampleWindows::Creation SampleWindows::creation() const
+{
+    return m_creation;
+}
+
+void SampleWindows::mark(const QString& name)
+{
+    addMark(name, m_startupTimer.nsecsElapsed() / 1e6);
+}
+
+const QVector<SampleWindows::Mark>& SampleWindows::marks() const
+{
+    return m_marks;
+}
+
+double SampleWindows::firstFrameMs() const
+{
+    const qint64 firstFrameNs = m_firstFrameNs.load();
+    return firstFrameNs < 0 ? -1.0 : firstFrameNs / 1e6;
+}
+
+void SampleWindows::showWindow(SampleWindows::Window window)
+{
+    if (window < 0 || window >= WindowCount)
+    {
+        return;
+    }
+
+    Entry& entry = m_entries[window];
+    if (entry.created)
+    {
+        entry.window->show();
+        entry.window->raise();
+        entry.window->requestActivate();
+    }
+    else
+    {
+        entry.showRequested = true;
+        create(window);
+    }
+}
+
+bool SampleWindows::isCreated(SampleWindows::Window window) const
+{
+    return window >= 0 && window < WindowCount && m_entries[window].created;
+}
+
+void SampleWindows::addMark(const QString& name, double ms)
+{
+    m_marks.append({ name, ms });
+    emit marked(name, ms);
+}
+
+void SampleWindows::onFirstFrame()
+{
+    // Frames already queued before the disconnect still arrive here
+    if (m_firstFrame)
+    {
+        return;
+    }
+    m_firstFrame = true;
+    disconnect(m_frameConnection);
+    disconnect(m_firstFrameConnection);
+
+    addMark("first frame", firstFrameMs());
+    emit firstFrameSwapped();
+
+    if (m_creation == DeferredCreation)
+    {
+        QTimer::singleShot(0, this, &SampleWindows::createNext);
+    }
+}
+
+// Windows are created one after another so only one is incubating next to the main view at a time
+void SampleWindows::createNext()
+{
+    for (int window = 0; window < WindowCount; ++window)
+    {
+        if (!m_entries[window].window)
+        {
+            create(static_cast<Window>(window));
+            return;
+        }
+    }
+}
+
+void SampleWindows::create(Window window)
+{
+    Entry& entry = m_entries[window];
+    if (entry.window)
+    {
+        return;
+    }
+
+    // Sharing the engine reuses the types and imports already loaded for the main view,
+    // its incubation controller then creates the window's items between the main view's frames
+    QQmlEngine* engine = m_mainView.engine();
+    entry.window.reset(new QQuickWindow());
+    entry.window->setTitle(entry.title);
+    entry.component = new QQmlComponent(engine, entry.source, QQmlComponent::Asynchronous, entry.window.get());
+    if (entry.component->isLoading())
+    {
+        connect(entry.component, &QQmlComponent::statusChanged, this, [this, window]() { onComponentStatus(window); });
+    }
+    else
+    {
+        onComponentStatus(window);
+    }
+}
+
+void SampleWindows::onComponentStatus(Window window)
+{
+    Entry& entry = m_entries[window];
+    if (entry.component->isError())
+    {
+        onFailed(window, errorString(entry.component->errors()));
+    }
+    else if (entry.component->isReady() && !entry.incubator)
+    {
+        entry.incubator.reset(new Incubator(*this, window));
+        entry.component->create(*entry.incubator);
+    }
+}
+
+// The window takes its size from the root item, which then follows the window as it is resized
+void SampleWindows::onIncubated(Window window)
+{
+    Entry& entry = m_entries[window];
+    QObject* object = entry.incubator->object();
+    QQuickItem* item = qobject_cast<QQuickItem*>(object);
+    if (!item)
+    {
+        delete object;
+        onFailed(window, QString("%1 is not an Item").arg(entry.source.toString()));
+        return;
+    }
+
+    item->setParent(entry.window.get());
+    item->setParentItem(entry.window->contentItem());
+    entry.window->resize(static_cast<int>(item->width()), static_cast<int>(item->height()));
+    connect(entry.window.get(), &QWindow::widthChanged, item, &QQuickItem::setWidth);
+    connect(entry.window.get(), &QWindow::heightChanged, item, &QQuickItem::setHeight);
+    entry.created = true;
+    addMark(QString(entry.title) + " ready", m_startupTimer.nsecsElapsed() / 1e6);
+
+    if (m_creation == DeferredCreation || entry.showRequested)
+    {
+        entry.window->show();
+    }
+    emit windowCreated(window);
+
+    if (m_creation == DeferredCreation)
+    {
+        QTimer::singleShot(0, this, &SampleWindows::createNext);
+    }
+}
+
+void SampleWindows::onFailed(Window window, const QString& errors)
+{
+    Entry& entry = m_entries[window];
+    qWarning("Unable to create %s\n%s", entry.title, qPrintable(errors));
+    addMark(QString(entry.title) + " failed", m_startupTimer.nsecsElapsed() / 1e6);
+
+    if (m_creation == DeferredCreation)
+    {
+        QTimer::singleShot(0, this, &SampleWindows::createNext);
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <qobject.h>
+#include <qelapsedtimer.h>
+#include <qurl.h>
+#include <qvector.h>
+#include <atomic>
+#include <memory>
+
+class QQuickView;
+class QQuickWindow;
+class QQmlComponent;
+
+/**
+* Creates the secondary palette and picker windows off the startup path
+* The windows share the main view's engine and are compiled and incubated
+* asynchronously, either straight after the main view's first frame or only
+* once they are first shown. The incubated root item is then placed in a plain
+* QQuickWindow. The time since start up is recorded at each step
+*/
+class SampleWindows : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Window
+    {
+        PaletteWindow,
+        PickerWindow,
+        WindowCount
+    };
+    Q_ENUM(Window)
+
+    enum Creation
+    {
+        DeferredCreation,
+        OnDemandCreation
+    };
+
+    struct Mark
+    {
+        QString name;
+        double ms;
+    };
+
+    /**
+    * startupTimer is expected to have been started as early as possible in main
+    */
+    SampleWindows(QQuickView& mainView, const QElapsedTimer& startupTimer, QObject* parent = nullptr);
+    virtual ~SampleWindows();
+
+    /**
+    * Deferred creation starts on the first frame of the main view, so it has to be set before it is shown
+    */
+    void setCreation(Creation creation);
+    Creation creation() const;
+
+    /**
+    * Records the time since start up under name
+    */
+    void mark(const QString& name);
+    const QVector<Mark>& marks() const;
+
+    /**
+    * Milliseconds from start up to the first frame of the main view, -1 until it is shown
+    */
+    double firstFrameMs() const;
+
+    /**
+    * Shows a window, creating it first if required
+    */
+    Q_INVOKABLE void showWindow(SampleWindows::Window window);
+    Q_INVOKABLE bool isCreated(SampleWindows::Window window) const;
+
+signals:
+    void marked(const QString& name, double ms);
+    void firstFrameSwapped();
+    void windowCreated(SampleWindows::Window window);
+
+private:
+    class Incubator;
+
+    struct Entry
+    {
+        const char* title;
+        QUrl source;
+        std::unique_ptr<QQuickWindow> window;
+        QQmlComponent* component = nullptr;
+        std::unique_ptr<Incubator> incubator;
+        bool created = false;
+        bool showRequested = false;
+    };
+
+    void addMark(const QString& name, double ms);
+    void onFirstFrame();
+    void createNext();
+    void create(Window window);
+    void onComponentStatus(Window window);
+    void onIncubated(Window window);
+    void onFailed(Window window, const QString& errors);
+
+    QQuickView& m_mainView;
+    const QElapsedTimer& m_startupTimer;
+    Creation m_creation = DeferredCreation;
+    bool m_firstFrame = false;
+    QVector<Mark> m_marks;
+    Entry m_entries[WindowCount];
+    std::atomic<qint64> m_firstFrameNs;
+    QMetaObject::Connection m_frameConnection;
+    QMetaObject::Connection m_firstFrameConnection;
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <qobject.h>
+#include <qcolor.h>
+#include <qlist.h>
+#include <qvariant.h>
 
 namespace Test
 {
@@ -17,10 +20,38 @@ namespace Test
             : QObject(parent)
             , m_id(ID)
         {
+            ++allocationCount();
+            ++liveCount();
         }
 
         ~Object()
         {
+            --liveCount();
+        }
+
+        int id() const
+        {
+            return m_id;
+        }
+
+        void setId(int id)
+        {
+            m_id = id;
+        }
+
+        /**
+        * Objects constructed so far and objects not yet destroyed, counted for benchmarks
+        */
+        static quint64& allocationCount()
+        {
+            static quint64 count = 0;
+            return count;
+        }
+
+        static qint64& liveCount()
+        {
+            static qint64 count = 0;
+            return count;
         }
 
         enum class ObjectEnum
@@ -36,6 +67,39 @@ namespace Test
         int m_id = 0;
     };
 
+    /**
+    * Lists exposed as whole list properties, as SampleModel used to expose its test lists,
+    * kept so qtSampleBench can compare element access against the typed lists
+    */
+    class LegacyLists : public QObject
+    {
+        Q_OBJECT
+        Q_PROPERTY(QList<int> intList MEMBER m_intList)
+        Q_PROPERTY(QVariantList colorList MEMBER m_colorList)
+        Q_PROPERTY(QList<QObject*> objectList MEMBER m_objectList)
+
+    public:
+        LegacyLists(QObject* parent = nullptr)
+            : QObject(parent)
+        {
+        }
+
+        void fill(int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                m_intList.append(i);
+                m_colorList.append(QColor(i & 0xFF, i & 0xFF, i & 0xFF));
+                m_objectList.append(new Object(i, this));
+            }
+        }
+
+    private:
+        QList<int> m_intList;
+        QVariantList m_colorList;
+        QList<QObject*> m_objectList;
+    };
+
     class Gadget
     {
         Q_GADGET